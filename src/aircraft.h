@@ -107,7 +107,7 @@ void UpdateAircraftCache(Vehicle *v);
  */
 struct Aircraft : public Vehicle {
 	/** Initializes the Vehicle to an aircraft */
-	Aircraft() { this->type = VEH_AIRCRAFT; }
+	Aircraft() { this->type = VEH_AIRCRAFT; UpdateVehicleTickList(this); }
 
 	/** We want to 'destruct' the right class. */
 	virtual ~Aircraft() { this->PreDestructor(); }
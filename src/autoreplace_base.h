@@ -32,7 +32,7 @@ struct EngineRenew : PoolItem<EngineRenew, EngineRenewID, &_EngineRenew_pool> {
 	inline bool IsValid() const { return this->from != INVALID_ENGINE; }
 };
 
-#define FOR_ALL_ENGINE_RENEWS_FROM(er, start) for (er = GetEngineRenew(start); er != NULL; er = (er->index + 1U < GetEngineRenewPoolSize()) ? GetEngineRenew(er->index + 1U) : NULL) if (er->IsValid())
+#define FOR_ALL_ENGINE_RENEWS_FROM(er, start) for (er = _EngineRenew_pool.GetNextLive(start); er != NULL; er = _EngineRenew_pool.GetNextLive(er->index + 1U)) if (er->IsValid())
 #define FOR_ALL_ENGINE_RENEWS(er) FOR_ALL_ENGINE_RENEWS_FROM(er, 0)
 
 #endif /* AUTOREPLACE_BASE_H */
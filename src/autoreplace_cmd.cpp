@@ -303,6 +303,9 @@ CommandCost MaybeReplaceVehicle(Vehicle *v, bool check, bool display_costs)
 	CommandCost cost, temp_cost;
 	bool stopped;
 
+	/* The counters of a dormant vehicle are copied to the new one */
+	WakeVehicle(v);
+
 	/* Remember the length in case we need to trim train later on
 	 * If it's not a train, the value is unused
 	 * round up to the length of the tiles used for the train instead of the train length instead
@@ -61,7 +61,7 @@ struct CargoPacket : PoolItem<CargoPacket, CargoPacketID, &_CargoPacket_pool> {
  * @param cp    the variable used as "iterator"
  * @param start the cargo packet ID of the first packet to iterate over
  */
-#define FOR_ALL_CARGOPACKETS_FROM(cp, start) for (cp = GetCargoPacket(start); cp != NULL; cp = (cp->index + 1U < GetCargoPacketPoolSize()) ? GetCargoPacket(cp->index + 1U) : NULL) if (cp->IsValid())
+#define FOR_ALL_CARGOPACKETS_FROM(cp, start) for (cp = _CargoPacket_pool.GetNextLive(start); cp != NULL; cp = _CargoPacket_pool.GetNextLive(cp->index + 1U)) if (cp->IsValid())
 
 /**
  * Iterate over all _valid_ cargo packets from the begin of the pool
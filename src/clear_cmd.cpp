@@ -133,7 +133,7 @@ static void AnimateTile_Clear(TileIndex tile)
 	/* unused */
 }
 
-void TileLoopClearHelper(TileIndex tile)
+void TileLoopClearHelper(TileIndex tile, TileLoopRegion *region)
 {
 	byte self;
 	byte neighbour;
@@ -167,12 +167,12 @@ void TileLoopClearHelper(TileIndex tile)
 		}
 	}
 
-	if (dirty != INVALID_TILE) MarkTileDirtyByTile(dirty);
+	if (dirty != INVALID_TILE) TileLoopMarkDirty(region, dirty);
 }
 
 
 /* convert into snowy tiles */
-static void TileLoopClearAlps(TileIndex tile)
+static void TileLoopClearAlps(TileIndex tile, TileLoopRegion *region)
 {
 	int k = GetTileZ(tile) - GetSnowLine() + TILE_HEIGHT;
 
@@ -195,10 +195,10 @@ static void TileLoopClearAlps(TileIndex tile)
 		}
 	}
 
-	MarkTileDirtyByTile(tile);
+	TileLoopMarkDirty(region, tile);
 }
 
-static void TileLoopClearDesert(TileIndex tile)
+static void TileLoopClearDesert(TileIndex tile, TileLoopRegion *region)
 {
 	if (IsClearGround(tile, CLEAR_DESERT)) return;
 
@@ -213,16 +213,22 @@ static void TileLoopClearDesert(TileIndex tile)
 		SetClearGroundDensity(tile, CLEAR_DESERT, 1);
 	}
 
-	MarkTileDirtyByTile(tile);
+	TileLoopMarkDirty(region, tile);
 }
 
-static void TileLoop_Clear(TileIndex tile)
+/**
+ * Tile loop of a clear tile.
+ * @param tile   the tile to loop
+ * @param region the tile loop region the tile belongs to, or NULL when
+ *               the tile loop runs serially
+ */
+void TileLoopClear(TileIndex tile, TileLoopRegion *region)
 {
-	TileLoopClearHelper(tile);
+	TileLoopClearHelper(tile, region);
 
 	switch (_opt.landscape) {
-		case LT_TROPIC: TileLoopClearDesert(tile); break;
-		case LT_ARCTIC: TileLoopClearAlps(tile);   break;
+		case LT_TROPIC: TileLoopClearDesert(tile, region); break;
+		case LT_ARCTIC: TileLoopClearAlps(tile, region);   break;
 	}
 
 	switch (GetClearGround(tile)) {
@@ -238,7 +244,7 @@ static void TileLoop_Clear(TileIndex tile)
 					AddClearDensity(tile, 1);
 				}
 			} else {
-				SetClearGroundDensity(tile, GB(Random(), 0, 8) > 21 ? CLEAR_GRASS : CLEAR_ROUGH, 3);
+				SetClearGroundDensity(tile, GB(TileLoopRandom(region), 0, 8) > 21 ? CLEAR_GRASS : CLEAR_ROUGH, 3);
 			}
 			break;
 
@@ -269,7 +275,12 @@ static void TileLoop_Clear(TileIndex tile)
 			return;
 	}
 
-	MarkTileDirtyByTile(tile);
+	TileLoopMarkDirty(region, tile);
+}
+
+static void TileLoop_Clear(TileIndex tile)
+{
+	TileLoopClear(tile, NULL);
 }
 
 void GenerateClearTile()
@@ -35,6 +35,10 @@
 #include "player_func.h"
 #include "player_base.h"
 #include "settings_type.h"
+#include "profiler.h"
+#include "meminfo.h"
+#include "track_type.h"
+#include "yapf/yapf.h"
 
 #ifdef ENABLE_NETWORK
 	#include "table/strings.h"
@@ -108,6 +112,25 @@ DEF_CONSOLE_HOOK(ConHookNoNetwork)
 	return true;
 }
 
+DEF_CONSOLE_HOOK(ConHookFastForward)
+{
+	if (!_networking) return true;
+
+	/* A network game can only run as fast as its slowest client, so only
+	 * a dedicated server without any clients may run unthrottled */
+	if (!_network_server || !_network_dedicated) {
+		IConsoleError("This command is only available to a dedicated network server.");
+		return false;
+	}
+
+	NetworkTCPSocketHandler *cs;
+	FOR_ALL_CLIENTS(cs) {
+		IConsoleError("This command is not available while clients are connected.");
+		return false;
+	}
+	return true;
+}
+
 #endif /* ENABLE_NETWORK */
 
 static void IConsoleHelp(const char *str)
@@ -407,6 +430,7 @@ DEF_CONSOLE_CMD(ConFastForwardGame)
 {
 	if (argc == 0) {
 		IConsoleHelp("Toggle fast forward. Usage: 'fast_forward'");
+		IConsoleHelp("The dedicated server then runs as fast as possible and reports its progress every ten seconds. Not available while clients are connected");
 		return true;
 	}
 
@@ -999,6 +1023,149 @@ DEF_CONSOLE_CMD(ConGetDate)
 }
 
 
+DEF_CONSOLE_CMD(ConProfile)
+{
+	if (argc == 0) {
+		IConsoleHelp("Show how long the parts of the game loop took during the last ticks. Usage: 'profile [<ticks> | reset]'");
+		IConsoleHelp("Without <ticks> all recorded ticks are used; 'reset' forgets all measurements made so far");
+		IConsoleHelp("The dedicated server also shows how many ticks started late or had to be dropped");
+		return true;
+	}
+
+	if (argc > 2) return false;
+
+	uint ticks = PROFILE_HISTORY_SIZE;
+	if (argc == 2) {
+		if (strcmp(argv[1], "reset") == 0) {
+			ResetGameLoopProfile();
+			IConsolePrint(_icolour_def, "Profile has been reset.");
+			return true;
+		}
+		ticks = atoi(argv[1]);
+		if (ticks == 0) return false;
+	}
+
+	GameLoopProfile profile;
+	GetGameLoopProfile(ticks, &profile);
+	if (profile.ticks == 0) {
+		IConsolePrint(_icolour_def, "No ticks have been profiled yet.");
+		return true;
+	}
+
+	IConsolePrintF(_icolour_def, "Profile of the last %u ticks (in microseconds):", profile.ticks);
+	IConsolePrintF(_icolour_def, "  %-16s %10s %10s", "phase", "average", "worst");
+	for (uint p = 0; p < GLP_END; p++) {
+		IConsolePrintF(_icolour_def, "  %-16s %10.1f %10u",
+			GetGameLoopPhaseName((GameLoopPhase)p), (double)profile.total[p] / profile.ticks, profile.worst[p]);
+	}
+
+	const TickScheduleStats *stats = &_tick_schedule_stats;
+	if (stats->ticks != 0) {
+		IConsolePrintF(_icolour_def, "Tick schedule: %u ticks, %u overruns, %u dropped, worst delay %u ms",
+			stats->ticks, stats->overruns, stats->dropped, stats->worst_delay);
+	}
+	return true;
+}
+
+DEF_CONSOLE_CMD(ConMemInfo)
+{
+	if (argc == 0) {
+		IConsoleHelp("Show the memory used by the map, the pools and the caches. Usage: 'meminfo [raw]'");
+		IConsoleHelp("With 'raw' every value is printed on its own line as '<part>.<field>=<value>', for use by scripts");
+		IConsoleHelp("Peak is the highest number of items in use since the start, '-' when it is not tracked");
+		return true;
+	}
+
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "raw") != 0)) return false;
+
+	MemoryUsage usage[MAX_MEMORY_USAGE];
+	uint n = GetMemoryUsage(usage, lengthof(usage));
+
+	if (argc == 2) {
+		for (uint i = 0; i < n; i++) {
+			IConsolePrintF(_icolour_def, "%s.allocated=%" OTTD_PRINTF64 "u", usage[i].name, usage[i].allocated);
+			IConsolePrintF(_icolour_def, "%s.used=%" OTTD_PRINTF64 "u", usage[i].name, usage[i].used);
+			IConsolePrintF(_icolour_def, "%s.items=%u", usage[i].name, usage[i].items);
+			IConsolePrintF(_icolour_def, "%s.capacity=%u", usage[i].name, usage[i].capacity);
+			IConsolePrintF(_icolour_def, "%s.peak=%u", usage[i].name, usage[i].peak);
+		}
+		return true;
+	}
+
+	uint64 allocated = 0;
+	uint64 used = 0;
+	IConsolePrintF(_icolour_def, "  %-20s %12s %12s %10s %10s %10s", "part", "alloc (KiB)", "used (KiB)", "items", "capacity", "peak");
+	for (uint i = 0; i < n; i++) {
+		char peak[16];
+		if (usage[i].peak == 0) {
+			strecpy(peak, "-", lastof(peak));
+		} else {
+			snprintf(peak, lengthof(peak), "%u", usage[i].peak);
+		}
+		IConsolePrintF(_icolour_def, "  %-20s %12u %12u %10u %10u %10s", usage[i].name,
+			(uint)(usage[i].allocated / 1024), (uint)(usage[i].used / 1024), usage[i].items, usage[i].capacity, peak);
+		allocated += usage[i].allocated;
+		used += usage[i].used;
+	}
+	IConsolePrintF(_icolour_def, "  %-20s %12u %12u", "total", (uint)(allocated / 1024), (uint)(used / 1024));
+	return true;
+}
+
+DEF_CONSOLE_CMD(ConHashStats)
+{
+	if (argc == 0) {
+		IConsoleHelp("Show the length of the chains of the hash used to find vehicles on a tile. Usage: 'hashstats [viewport]'");
+		IConsoleHelp("With 'viewport' the hash used to find the vehicles to draw in a viewport is shown instead");
+		IConsoleHelp("'Per lookup' is the average number of vehicles walked when looking at the bucket of a vehicle");
+		return true;
+	}
+
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "viewport") != 0)) return false;
+
+	VehicleHashStats stats;
+	if (argc == 2) {
+		GetViewportVehicleHashStats(&stats);
+	} else {
+		GetVehiclePosHashStats(&stats);
+	}
+
+	IConsolePrintF(_icolour_def, "Size:       %u x %u buckets", stats.size_x, stats.size_y);
+	IConsolePrintF(_icolour_def, "Vehicles:   %u", stats.vehicles);
+	IConsolePrintF(_icolour_def, "Used:       %u buckets", stats.used);
+	IConsolePrintF(_icolour_def, "Longest:    %u vehicles", stats.longest);
+	if (stats.used != 0) {
+		IConsolePrintF(_icolour_def, "Average:    %u.%02u vehicles per used bucket", stats.vehicles / stats.used, stats.vehicles * 100 / stats.used % 100);
+		IConsolePrintF(_icolour_def, "Per lookup: %u.%02u vehicles", (uint)(stats.squares / stats.vehicles), (uint)(stats.squares * 100 / stats.vehicles % 100));
+	}
+	return true;
+}
+
+DEF_CONSOLE_CMD(ConYapfStats)
+{
+	if (argc == 0) {
+		IConsoleHelp("Show how often the rail and road pathfinders found segment costs in their caches. Usage: 'yapfstats'");
+		IConsoleHelp("'Invalidated' counts the cached segments dropped because track or road they pass was changed");
+		IConsoleHelp("The 'route' line counts the junctions trains took from the route of an earlier search; its 'segments' are the trains with a route");
+		return true;
+	}
+
+	if (argc != 1) return false;
+
+	YapfCacheStats stats[3];
+	YapfGetRailCacheStats(&stats[0]);
+	YapfGetRoadCacheStats(&stats[1]);
+	YapfGetRailRouteStats(&stats[2]);
+	static const char * const names[] = {"rail", "road", "route"};
+
+	IConsolePrintF(_icolour_def, "  %-6s %10s %12s %12s %8s %12s %8s", "cache", "segments", "hits", "misses", "hit rate", "invalidated", "flushes");
+	for (uint i = 0; i < lengthof(stats); i++) {
+		uint64 lookups = stats[i].hits + stats[i].misses;
+		IConsolePrintF(_icolour_def, "  %-6s %10u %12" OTTD_PRINTF64 "u %12" OTTD_PRINTF64 "u %7u%% %12" OTTD_PRINTF64 "u %8u", names[i],
+			stats[i].segments, stats[i].hits, stats[i].misses, lookups == 0 ? 0 : (uint)(stats[i].hits * 100 / lookups), stats[i].invalidated, stats[i].flushes);
+	}
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConAlias)
 {
 	IConsoleAlias *alias;
@@ -1611,6 +1778,10 @@ void IConsoleStdLibRegister()
 	IConsoleCmdRegister("restart",      ConRestart);
 	IConsoleCmdRegister("getseed",      ConGetSeed);
 	IConsoleCmdRegister("getdate",      ConGetDate);
+	IConsoleCmdRegister("profile",      ConProfile);
+	IConsoleCmdRegister("meminfo",      ConMemInfo);
+	IConsoleCmdRegister("hashstats",    ConHashStats);
+	IConsoleCmdRegister("yapfstats",    ConYapfStats);
 	IConsoleCmdRegister("quit",         ConExit);
 	IConsoleCmdRegister("resetengines", ConResetEngines);
 	IConsoleCmdRegister("return",       ConReturn);
@@ -1622,7 +1793,7 @@ void IConsoleStdLibRegister()
 	IConsoleCmdRegister("pause",        ConPauseGame);
 	IConsoleCmdRegister("unpause",      ConUnPauseGame);
 	IConsoleCmdRegister("fast_forward", ConFastForwardGame);
-	IConsoleCmdHookAdd("fast_forward",  ICONSOLE_HOOK_ACCESS, ConHookClientOnly);
+	IConsoleCmdHookAdd("fast_forward",  ICONSOLE_HOOK_ACCESS, ConHookFastForward);
 	IConsoleCmdRegister("toggle_ai",    ConToggleAI);
 	IConsoleCmdHookAdd("toggle_ai",     ICONSOLE_HOOK_ACCESS, ConHookClientOnly);
 	IConsoleCmdRegister("rm",           ConRemove);
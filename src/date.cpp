@@ -171,6 +171,7 @@ extern void WaypointsDailyLoop();
 extern void ChatMessageDailyLoop();
 extern void EnginesDailyLoop();
 extern void DisasterDailyLoop();
+extern void IndustryDailyLoop();
 
 extern void PlayersMonthlyLoop();
 extern void EnginesMonthlyLoop();
@@ -243,6 +244,7 @@ void IncreaseDate()
 	if (_game_mode != GM_MENU) {
 		InvalidateWindowWidget(WC_STATUS_BAR, 0, 0);
 		EnginesDailyLoop();
+		IndustryDailyLoop();
 	}
 
 	/* check if we entered a new month? */
@@ -97,6 +97,13 @@ const char *GetDebugString();
 	}\
 }
 
+/**
+ * Get a timestamp in microseconds, to measure how long something took.
+ * Only differences between two timestamps are meaningful.
+ * @return the current timestamp
+ */
+uint64 GetTimeMicroseconds();
+
 void ShowInfo(const char *str);
 void CDECL ShowInfoF(const char *str, ...);
 
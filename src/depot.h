@@ -32,7 +32,7 @@ static inline bool IsValidDepotID(DepotID index)
 
 void ShowDepotWindow(TileIndex tile, VehicleType type);
 
-#define FOR_ALL_DEPOTS_FROM(d, start) for (d = GetDepot(start); d != NULL; d = (d->index + 1U < GetDepotPoolSize()) ? GetDepot(d->index + 1U) : NULL) if (d->IsValid())
+#define FOR_ALL_DEPOTS_FROM(d, start) for (d = _Depot_pool.GetNextLive(start); d != NULL; d = _Depot_pool.GetNextLive(d->index + 1U)) if (d->IsValid())
 #define FOR_ALL_DEPOTS(d) FOR_ALL_DEPOTS_FROM(d, 0)
 
 /**
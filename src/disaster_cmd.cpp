@@ -372,6 +372,7 @@ static void DisasterTick_Ufo(Vehicle *v)
 					u->index,
 					0);
 
+				WakeVehicle(u);
 				for (Vehicle *w = u; w != NULL; w = w->Next()) {
 					w->vehstatus |= VS_CRASHED;
 					MarkSingleVehicleDirty(w);
@@ -47,6 +47,7 @@
 #include "gfx_func.h"
 #include "autoreplace_func.h"
 #include "signs.h"
+#include "yapf/yapf.h"
 
 #include "table/strings.h"
 #include "table/sprites.h"
@@ -435,6 +436,10 @@ void ChangeOwnershipOfPlayerItems(PlayerID old_player, PlayerID new_player)
 			ChangeTileOwner(tile, old_player, new_player);
 		} while (++tile != MapSize());
 
+		/* Track of other owners ends the segments of YAPF, so the cached
+		 * segments of the whole map may be different now */
+		YapfNotifyTrackLayoutChange(INVALID_TILE, INVALID_TRACK);
+
 		if (new_player != PLAYER_SPECTATOR) {
 			/* Update all signals because there can be new segment that was owned by two players
 			 * and signals were not propagated
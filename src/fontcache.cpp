@@ -10,6 +10,7 @@
 #include "spriteloader/spriteloader.hpp"
 #include "blitter/factory.hpp"
 #include "gfx_func.h"
+#include "meminfo.h"
 #include "core/alloc_func.hpp"
 #include "core/math_func.hpp"
 
@@ -368,8 +369,12 @@ static void SetGlyphPtr(FontSize size, WChar key, const GlyphEntry *glyph)
 	_glyph_ptr[size][GB(key, 8, 8)][GB(key, 0, 8)].width  = glyph->width;
 }
 
+/** Number of bytes allocated for the sprites of rendered glyphs. */
+static size_t _glyph_sprite_bytes = 0;
+
 void *AllocateFont(size_t size)
 {
+	_glyph_sprite_bytes += size;
 	return MallocT<byte>(size);
 }
 
@@ -520,6 +525,47 @@ void SetUnicodeGlyph(FontSize size, uint32 key, SpriteID sprite)
 }
 
 
+/**
+ * Get the memory the glyph tables and the rendered glyphs take.
+ * @param usage the place to store the memory usage in
+ */
+void GetFontCacheMemoryUsage(MemoryUsage *usage)
+{
+	usage->name = "font_cache";
+	usage->allocated = 0;
+	usage->items = 0;
+	usage->capacity = 0;
+	usage->peak = 0;
+
+	for (FontSize size = FS_NORMAL; size != FS_END; size++) {
+		if (_unicode_glyph_map[size] == NULL) continue;
+		usage->allocated += 256 * sizeof(*_unicode_glyph_map[size]);
+		for (uint i = 0; i < 256; i++) {
+			if (_unicode_glyph_map[size][i] != NULL) usage->allocated += 256 * sizeof(**_unicode_glyph_map[size]);
+		}
+	}
+
+#ifdef WITH_FREETYPE
+	for (FontSize size = FS_NORMAL; size != FS_END; size++) {
+		if (_glyph_ptr[size] == NULL) continue;
+		usage->allocated += 256 * sizeof(*_glyph_ptr[size]);
+		for (uint i = 0; i < 256; i++) {
+			if (_glyph_ptr[size][i] == NULL) continue;
+			usage->allocated += 256 * sizeof(**_glyph_ptr[size]);
+			usage->capacity += 256;
+			for (uint j = 0; j < 256; j++) {
+				if (_glyph_ptr[size][i][j].sprite != NULL) usage->items++;
+			}
+		}
+	}
+	/* Glyphs are never removed from the cache */
+	usage->allocated += _glyph_sprite_bytes;
+	usage->peak = usage->items;
+#endif /* WITH_FREETYPE */
+
+	usage->used = usage->allocated;
+}
+
 void InitializeUnicodeGlyphMap()
 {
 	for (FontSize size = FS_NORMAL; size != FS_END; size++) {
@@ -14,6 +14,9 @@ void SetUnicodeGlyph(FontSize size, uint32 key, SpriteID sprite);
 /** Initialize the glyph map */
 void InitializeUnicodeGlyphMap();
 
+/** Get the memory the glyph tables and the rendered glyphs take */
+void GetFontCacheMemoryUsage(struct MemoryUsage *usage);
+
 #ifdef WITH_FREETYPE
 
 struct FreeTypeSettings {
@@ -9,11 +9,13 @@
 #include "command_type.h"
 #include "tile_cmd.h"
 
+struct TileLoopRegion;
+
 /* clear_land.cpp */
 void DrawHillyLandTile(const TileInfo *ti);
 void DrawClearLandTile(const TileInfo *ti, byte set);
 void DrawClearLandFence(const TileInfo *ti);
-void TileLoopClearHelper(TileIndex tile);
+void TileLoopClearHelper(TileIndex tile, TileLoopRegion *region = NULL);
 
 /* players.cpp */
 bool CheckPlayerHasMoney(CommandCost cost);
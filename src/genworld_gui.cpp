@@ -28,6 +28,7 @@
 #include "widgets/dropdown_type.h"
 #include "widgets/dropdown_func.h"
 #include "core/random_func.hpp"
+#include "map_type.h"
 
 #include "table/strings.h"
 #include "table/sprites.h"
@@ -235,7 +236,7 @@ static DropDownList *BuildMapsizeDropDown()
 {
 	DropDownList *list = new DropDownList();
 
-	for (uint i = 6; i <= 11; i++) {
+	for (uint i = MIN_MAP_SIZE_BITS; i <= MAX_MAP_SIZE_BITS; i++) {
 		DropDownListParamStringItem *item = new DropDownListParamStringItem(STR_JUST_INT, i, false);
 		item->SetParam(0, 1 << i);
 		list->push_back(item);
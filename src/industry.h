@@ -113,7 +113,8 @@ struct Industry : PoolItem<Industry, IndustryID, &_Industry_pool> {
 	byte last_month_pct_transported[2]; ///< percentage transported per cargo in the last full month
 	uint16 last_month_production[2];    ///< total units produced per cargo in the last full month
 	uint16 last_month_transported[2];   ///< total units transported per cargo in the last full month
-	uint16 counter;                     ///< used for animation and/or production (if available cargo)
+	uint16 counter;                     ///< used for animation and/or production (if available cargo); only up to date when saving, see GetIndustryCounter()
+	uint16 counter_base;                ///< counter plus the time of the production schedule
 
 	IndustryType type;                  ///< type of industry.
 	OwnerByte owner;                    ///< owner of the industry.  Which SHOULD always be (imho) OWNER_NONE
@@ -237,6 +238,8 @@ const IndustrySpec *GetIndustrySpec(IndustryType thistype);    ///< Array of ind
 const IndustryTileSpec *GetIndustryTileSpec(IndustryGfx gfx);  ///< Array of industry tiles data
 void ResetIndustries();
 void PlantRandomFarmField(const Industry *i);
+uint16 GetIndustryCounter(const Industry *i);
+void RebuildIndustryProductionSchedule();
 
 /* writable arrays of specs */
 extern IndustrySpec _industry_specs[NUM_INDUSTRYTYPES];
@@ -351,7 +354,7 @@ static inline Industry *GetRandomIndustry()
 	return GetIndustry(index);
 }
 
-#define FOR_ALL_INDUSTRIES_FROM(i, start) for (i = GetIndustry(start); i != NULL; i = (i->index + 1U < GetIndustryPoolSize()) ? GetIndustry(i->index + 1U) : NULL) if (i->IsValid())
+#define FOR_ALL_INDUSTRIES_FROM(i, start) for (i = _Industry_pool.GetNextLive(start); i != NULL; i = _Industry_pool.GetNextLive(i->index + 1U)) if (i->IsValid())
 #define FOR_ALL_INDUSTRIES(i) FOR_ALL_INDUSTRIES_FROM(i, 0)
 
 extern const Industry **_industry_sort;
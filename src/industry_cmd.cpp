@@ -35,6 +35,7 @@
 #include "date_func.h"
 #include "vehicle_func.h"
 #include "sound_func.h"
+#include "timer_wheel.h"
 
 #include "table/strings.h"
 #include "table/sprites.h"
@@ -49,6 +50,11 @@ void BuildOilRig(TileIndex tile);
 static byte _industry_sound_ctr;
 static TileIndex _industry_sound_tile;
 
+static uint IndustryProductionTimerProc(uint index);
+
+/** Sounds and production of all industries, driven by their production counters */
+static TimerWheel _industry_production_wheel(&IndustryProductionTimerProc);
+
 int _total_industries;                      //general counter
 uint16 _industry_counts[NUM_INDUSTRYTYPES]; // Number of industries per type ingame
 
@@ -137,6 +143,8 @@ Industry::~Industry()
 {
 	if (CleaningPool()) return;
 
+	_industry_production_wheel.Cancel(this->index);
+
 	/* Industry can also be destroyed when not fully initialized.
 	 * This means that we do not have to clear tiles either. */
 	if (this->width == 0) {
@@ -998,14 +1006,60 @@ static void ChopLumberMillTrees(Industry *i)
 		i->produced_cargo_waiting[0] = min(0xffff, i->produced_cargo_waiting[0] + 45); ///< Found a tree, add according value to waiting cargo
 }
 
+/**
+ * Get the production counter of an industry. It is decremented every tick;
+ * the industry may play a sound when it is a multiple of 64 before the
+ * decrement and produces cargo when it is a multiple of 256 after it.
+ * @param i the industry
+ * @return the current value of the counter
+ */
+uint16 GetIndustryCounter(const Industry *i)
+{
+	return i->counter_base - _industry_production_wheel.GetTime();
+}
+
+/**
+ * Get the number of ticks until an industry next has to play a sound or
+ * produce cargo.
+ * @param counter the current production counter of the industry
+ * @return the ticks until that happens, 1 being the next tick
+ */
+static uint GetIndustryProductionDelay(uint16 counter)
+{
+	uint sound   = (counter & 0x3F) + 1;
+	uint produce = ((counter - 1) & 0xFF) + 1;
+	return min(sound, produce);
+}
+
+/**
+ * Schedule the production of an industry from its saved counter.
+ * @param i the industry; its counter holds the current production counter
+ */
+static void StartIndustryProduction(Industry *i)
+{
+	i->counter_base = i->counter + _industry_production_wheel.GetTime();
+	_industry_production_wheel.Schedule(i->index, GetIndustryProductionDelay(i->counter));
+}
+
+/** Schedule the production of all industries after loading a game. */
+void RebuildIndustryProductionSchedule()
+{
+	_industry_production_wheel.Clear();
+
+	Industry *i;
+	FOR_ALL_INDUSTRIES(i) StartIndustryProduction(i);
+}
+
 static void ProduceIndustryGoods(Industry *i)
 {
 	uint32 r;
 	uint num;
 	const IndustrySpec *indsp = GetIndustrySpec(i->type);
+	/* The counter has already been decremented for this tick */
+	uint16 counter = GetIndustryCounter(i);
 
 	/* play a sound? */
-	if ((i->counter & 0x3F) == 0) {
+	if (((counter + 1) & 0x3F) == 0) {
 		if (Chance16R(1, 14, r) && (num = indsp->number_of_sounds) != 0) {
 			SndPlayTileFx(
 				(SoundFx)(indsp->random_sounds[((r >> 16) * num) >> 16]),
@@ -1013,10 +1067,8 @@ static void ProduceIndustryGoods(Industry *i)
 		}
 	}
 
-	i->counter--;
-
 	/* produce some cargo */
-	if ((i->counter & 0xFF) == 0) {
+	if ((counter & 0xFF) == 0) {
 		if (HasBit(indsp->callback_flags, CBM_IND_PRODUCTION_256_TICKS)) IndustryProductionCallback(i, 1);
 
 		IndustryBehaviour indbehav = indsp->behaviour;
@@ -1034,7 +1086,7 @@ static void ProduceIndustryGoods(Industry *i)
 			if (plant) PlantRandomFarmField(i);
 		}
 		if ((indbehav & INDUSTRYBEH_CUT_TREES) != 0) {
-			bool cut = ((i->counter & 0x1FF) == 0);
+			bool cut = ((counter & 0x1FF) == 0);
 			if (HasBit(indsp->callback_flags, CBM_IND_SPECIAL_EFFECT)) {
 				cut = (GetIndustryCallback(CBID_INDUSTRY_SPECIAL_EFFECT, 0, 1, i, i->type, i->xy) != 0);
 			}
@@ -1047,10 +1099,15 @@ static void ProduceIndustryGoods(Industry *i)
 	}
 }
 
-void OnTick_Industry()
+static uint IndustryProductionTimerProc(uint index)
 {
-	Industry *i;
+	Industry *i = GetIndustry(index);
+	ProduceIndustryGoods(i);
+	return GetIndustryProductionDelay(GetIndustryCounter(i));
+}
 
+void OnTick_Industry()
+{
 	if (_industry_sound_ctr != 0) {
 		_industry_sound_ctr++;
 
@@ -1064,9 +1121,7 @@ void OnTick_Industry()
 
 	if (_game_mode == GM_EDITOR) return;
 
-	FOR_ALL_INDUSTRIES(i) {
-		ProduceIndustryGoods(i);
-	}
+	_industry_production_wheel.Tick();
 }
 
 static bool CheckNewIndustry_NULL(TileIndex tile)
@@ -1476,6 +1531,7 @@ static void DoCreateNewIndustry(Industry *i, TileIndex tile, int type, const Ind
 	r = Random();
 	i->random_color = GB(r, 0, 4);
 	i->counter = GB(r, 4, 12);
+	StartIndustryProduction(i);
 	i->random = GB(r, 16, 16);
 	i->produced_cargo_waiting[0] = 0;
 	i->produced_cargo_waiting[1] = 0;
@@ -2223,6 +2279,46 @@ static void ChangeIndustryProduction(Industry *i, bool monthly)
 	}
 }
 
+/** Number of days of the month over which the monthly production changes are spread. */
+static const uint INDUSTRY_CHANGE_DAYS = 28;
+
+/**
+ * Runs the monthly production change for every INDUSTRY_CHANGE_DAYS industry starting at group.
+ * The changes only use last month's statistics, which are constant during the month,
+ * so running them on different days does not make them depend on each other.
+ * @param group the day of the month, starting at 0, of the industries to change
+ */
+static void RunIndustryProductionChange(uint group)
+{
+	uint total = GetMaxIndustryIndex() + 1;
+
+	for (uint i = group; i < total; i += INDUSTRY_CHANGE_DAYS) {
+		Industry *ind = GetIndustry(i);
+
+		if (ind->IsValid() && ind->prod_level != PRODLEVEL_CLOSURE) ChangeIndustryProduction(ind, true);
+	}
+}
+
+void IndustryDailyLoop()
+{
+	YearMonthDay ymd;
+	ConvertDateToYMD(_date, &ymd);
+
+	/* The first group is run by IndustryMonthlyLoop, after the statistics are updated */
+	if (ymd.day == 1 || ymd.day > INDUSTRY_CHANGE_DAYS) return;
+
+	PlayerID old_player = _current_player;
+	_current_player = OWNER_NONE;
+
+	RunIndustryProductionChange(ymd.day - 1);
+
+	_current_player = old_player;
+
+	/* production-change */
+	_industry_sort_dirty = true;
+	InvalidateWindow(WC_INDUSTRY_DIRECTORY, 0);
+}
+
 void IndustryMonthlyLoop()
 {
 	Industry *i;
@@ -2231,13 +2327,11 @@ void IndustryMonthlyLoop()
 
 	FOR_ALL_INDUSTRIES(i) {
 		UpdateIndustryStatistics(i);
-		if (i->prod_level == PRODLEVEL_CLOSURE) {
-			delete i;
-		} else {
-			ChangeIndustryProduction(i, true);
-		}
+		if (i->prod_level == PRODLEVEL_CLOSURE) delete i;
 	}
 
+	RunIndustryProductionChange(0);
+
 	/* 3% chance that we start a new industry */
 	if (Chance16(3, 100)) {
 		MaybeNewIndustry();
@@ -2262,6 +2356,7 @@ void InitializeIndustries()
 	ResetIndustryCounts();
 	_industry_sort_dirty = true;
 	_industry_sound_tile = 0;
+	_industry_production_wheel.Clear();
 }
 
 bool IndustrySpec::IsRawIndustry() const
@@ -2383,6 +2478,7 @@ static void Save_INDY()
 
 	/* Write the industries */
 	FOR_ALL_INDUSTRIES(ind) {
+		ind->counter = GetIndustryCounter(ind);
 		SlSetArrayIndex(ind->index);
 		SlObject(ind, _industry_desc);
 	}
@@ -24,6 +24,11 @@
 #include "vehicle_func.h"
 #include "settings_type.h"
 #include "water.h"
+#include "profiler.h"
+#include "tree_map.h"
+#include "sound_func.h"
+#include "thread.h"
+#include "yapf/yapf.h"
 
 #include "table/sprites.h"
 
@@ -613,6 +618,292 @@ CommandCost CmdClearArea(TileIndex tile, uint32 flags, uint32 p1, uint32 p2)
 #define TILELOOP_ASSERTMASK ((TILELOOP_SIZE - 1) + ((TILELOOP_SIZE - 1) << MapLogX()))
 #define TILELOOP_CHKMASK (((1 << (MapLogX() - TILELOOP_BITS))-1) << TILELOOP_BITS)
 
+/**
+ * Get a random number for the tile loop.
+ * @param region the region being looped, or NULL for the serial tile loop
+ * @return the random number
+ */
+uint32 TileLoopRandom(TileLoopRegion *region)
+{
+	if (region == NULL) return Random();
+	return region->random.Next();
+}
+
+/**
+ * Mark a tile dirty from within the tile loop.
+ * @param region the region being looped, or NULL for the serial tile loop
+ * @param tile the tile to mark dirty
+ */
+void TileLoopMarkDirty(TileLoopRegion *region, TileIndex tile)
+{
+	if (region == NULL) {
+		MarkTileDirtyByTile(tile);
+	} else {
+		*region->dirty.Append() = tile;
+	}
+}
+
+/**
+ * Play a sound from within the tile loop.
+ * @param region the region being looped, or NULL for the serial tile loop
+ * @param fx the sound to play
+ * @param tile the tile to play it at
+ */
+void TileLoopPlaySound(TileLoopRegion *region, SoundFx fx, TileIndex tile)
+{
+	if (region == NULL) {
+		SndPlayTileFx(fx, tile);
+	} else {
+		TileLoopSound *ts = region->sounds.Append();
+		ts->fx = fx;
+		ts->tile = tile;
+	}
+}
+
+/**
+ * Tell YAPF that the tracks of a tile changed, from within the tile loop.
+ * @param region the region being looped, or NULL for the serial tile loop
+ * @param tile the tile that changed
+ */
+void TileLoopNotifyTrackLayoutChange(TileLoopRegion *region, TileIndex tile)
+{
+	if (region == NULL) {
+		YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
+	} else {
+		*region->changed.Append() = tile;
+	}
+}
+
+/**
+ * Whether the tile loop of a tile only touches the tile itself and its
+ * direct neighbours. As tiles of the stripe are TILELOOP_SIZE tiles apart,
+ * these tiles can be looped at the same time.
+ * @param tile the tile to check
+ * @return true if the tile can be looped within its region
+ */
+static bool IsTileLoopLocal(TileIndex tile)
+{
+	switch (GetTileType(tile)) {
+		case MP_CLEAR: return true;
+		case MP_TREES: return GetTreeGround(tile) != TREE_GROUND_SHORE;
+		default:       return false;
+	}
+}
+
+static TileLoopRegion *_tile_loop_regions = NULL; ///< one region per row of the stripe
+static uint _tile_loop_region_count = 0;          ///< number of allocated regions
+
+/** The rows a single thread of the parallel tile loop handles. */
+struct TileLoopJob {
+	TileIndex first_tile; ///< first tile of the stripe
+	uint first_row;       ///< first row of the stripe to handle
+	uint last_row;        ///< one past the last row to handle
+};
+
+static void *RunTileLoopJob(void *arg)
+{
+	const TileLoopJob *job = (const TileLoopJob*)arg;
+	uint row_length = MapSizeX() / TILELOOP_SIZE;
+
+	for (uint row = job->first_row; row < job->last_row; row++) {
+		TileLoopRegion *region = &_tile_loop_regions[row];
+		TileIndex tile = job->first_tile + TileDiffXY(0, row * TILELOOP_SIZE);
+
+		for (uint i = 0; i < row_length; i++, tile += TILELOOP_SIZE) {
+			if (!IsTileLoopLocal(tile)) {
+				*region->deferred.Append() = tile;
+			} else if (IsTileType(tile, MP_CLEAR)) {
+				TileLoopClear(tile, region);
+			} else {
+				TileLoopTrees(tile, region);
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/** A thread of the parallel tile loop; it is kept running between ticks. */
+struct TileLoopWorker {
+	OTTDThreadFunc proc;  ///< the function handling the job of this tick
+	void *arg;            ///< the job of this tick
+	OTTDSemaphore *start; ///< signalled when the job of this tick is set
+	OTTDThread *thread;   ///< the thread handling the jobs
+};
+
+static TileLoopWorker _tile_loop_workers[63];     ///< the worker threads; the game loop thread handles a job too
+static uint _tile_loop_num_workers = 0;           ///< number of running worker threads
+static uint _tile_loop_wanted_workers = 0;        ///< number of worker threads the patch setting asks for
+static OTTDSemaphore *_tile_loop_done = NULL;     ///< signalled by a worker when its job is done
+static bool _tile_loop_workers_quit = false;      ///< tells the workers to stop instead of handling a job
+
+static void *RunTileLoopWorker(void *arg)
+{
+	TileLoopWorker *w = (TileLoopWorker*)arg;
+
+	for (;;) {
+		OTTDWaitSemaphore(w->start);
+		if (_tile_loop_workers_quit) break;
+		w->proc(w->arg);
+		OTTDSignalSemaphore(_tile_loop_done);
+	}
+
+	return NULL;
+}
+
+/** Stop all worker threads of the parallel tile loop. */
+static void StopTileLoopWorkers()
+{
+	_tile_loop_workers_quit = true;
+	for (uint i = 0; i < _tile_loop_num_workers; i++) {
+		OTTDSignalSemaphore(_tile_loop_workers[i].start);
+	}
+	for (uint i = 0; i < _tile_loop_num_workers; i++) {
+		OTTDJoinThread(_tile_loop_workers[i].thread);
+		OTTDDestroySemaphore(_tile_loop_workers[i].start);
+	}
+	_tile_loop_workers_quit = false;
+	_tile_loop_num_workers = 0;
+}
+
+/**
+ * Start the worker threads of the parallel tile loop. When the system
+ * refuses to make more threads, fewer workers are started.
+ * @param count the number of workers to start
+ */
+static void StartTileLoopWorkers(uint count)
+{
+	if (_tile_loop_done == NULL) _tile_loop_done = OTTDCreateSemaphore();
+	if (_tile_loop_done == NULL) return;
+
+	while (_tile_loop_num_workers < count) {
+		TileLoopWorker *w = &_tile_loop_workers[_tile_loop_num_workers];
+
+		w->start = OTTDCreateSemaphore();
+		if (w->start == NULL) break;
+		w->thread = OTTDCreateThread(&RunTileLoopWorker, w);
+		if (w->thread == NULL) {
+			OTTDDestroySemaphore(w->start);
+			break;
+		}
+		_tile_loop_num_workers++;
+	}
+}
+
+/**
+ * Get the number of jobs that can run at the same time on the worker
+ * threads of the parallel tile loop, starting or stopping workers when
+ * the tile_loop_threads patch setting changed.
+ * @return the number of jobs, including the one of the game loop thread
+ */
+uint GetWorkerJobCount()
+{
+	uint wanted_workers = ClampU(_patches.tile_loop_threads, 1, lengthof(_tile_loop_workers) + 1) - 1;
+	if (wanted_workers != _tile_loop_wanted_workers) {
+		StopTileLoopWorkers();
+		StartTileLoopWorkers(wanted_workers);
+		_tile_loop_wanted_workers = wanted_workers;
+	}
+	return _tile_loop_num_workers + 1;
+}
+
+/**
+ * Run jobs on the worker threads of the parallel tile loop and wait
+ * until all of them are done. The first job is run by this thread.
+ * The jobs must not change anything another job reads or changes.
+ * @param proc     the function handling a job
+ * @param args     the job of each thread
+ * @param num_jobs the number of jobs, at most GetWorkerJobCount()
+ */
+void RunWorkerJobs(OTTDThreadFunc proc, void * const *args, uint num_jobs)
+{
+	assert(num_jobs >= 1 && num_jobs <= _tile_loop_num_workers + 1);
+
+	for (uint i = 1; i < num_jobs; i++) {
+		TileLoopWorker *w = &_tile_loop_workers[i - 1];
+		w->proc = proc;
+		w->arg = args[i];
+		OTTDSignalSemaphore(w->start);
+	}
+
+	proc(args[0]);
+
+	for (uint i = 1; i < num_jobs; i++) {
+		OTTDWaitSemaphore(_tile_loop_done);
+	}
+}
+
+/**
+ * Set the rows a job of the parallel tile loop handles.
+ * @param job the job to set
+ * @param first_tile the first tile of the stripe
+ * @param rows the number of rows of the stripe
+ * @param i the number of the job
+ * @param num_jobs the number of jobs the rows are split over
+ */
+static void SetTileLoopJob(TileLoopJob *job, TileIndex first_tile, uint rows, uint i, uint num_jobs)
+{
+	job->first_tile = first_tile;
+	job->first_row  = rows * i / num_jobs;
+	job->last_row   = rows * (i + 1) / num_jobs;
+}
+
+/**
+ * Run the tile loop over the stripe in independent regions, one per row.
+ * Clear and tree tiles only change the tile itself or a direct neighbour,
+ * so they are looped on worker threads with a random stream per region.
+ * Afterwards the queued side effects and all other tiles are handled in
+ * the order of the rows, so the result does not depend on the number of
+ * threads or on their timing.
+ * @param first_tile the first tile of the stripe
+ */
+static void RunParallelTileLoop(TileIndex first_tile)
+{
+	uint rows = MapSizeY() / TILELOOP_SIZE;
+	if (_tile_loop_region_count != rows) {
+		delete[] _tile_loop_regions;
+		_tile_loop_regions = new TileLoopRegion[rows];
+		_tile_loop_region_count = rows;
+	}
+
+	/* One draw from the game's random stream per tick seeds all regions */
+	uint32 seed = Random();
+	for (uint row = 0; row < rows; row++) {
+		TileLoopRegion *region = &_tile_loop_regions[row];
+		region->random.SetSeed(seed ^ (row * 0x9E3779B9));
+		region->dirty.Clear();
+		region->sounds.Clear();
+		region->deferred.Clear();
+		region->changed.Clear();
+	}
+
+	uint num_jobs = minu(GetWorkerJobCount(), rows);
+	TileLoopJob jobs[lengthof(_tile_loop_workers) + 1];
+	void *args[lengthof(_tile_loop_workers) + 1];
+	for (uint i = 0; i < num_jobs; i++) {
+		SetTileLoopJob(&jobs[i], first_tile, rows, i, num_jobs);
+		args[i] = &jobs[i];
+	}
+	RunWorkerJobs(&RunTileLoopJob, args, num_jobs);
+
+	for (uint row = 0; row < rows; row++) {
+		TileLoopRegion *region = &_tile_loop_regions[row];
+
+		for (const TileIndex *t = region->dirty.Begin(); t != region->dirty.End(); t++) {
+			MarkTileDirtyByTile(*t);
+		}
+		for (const TileLoopSound *ts = region->sounds.Begin(); ts != region->sounds.End(); ts++) {
+			SndPlayTileFx(ts->fx, ts->tile);
+		}
+		for (const TileIndex *t = region->changed.Begin(); t != region->changed.End(); t++) {
+			YapfNotifyTrackLayoutChange(*t, INVALID_TRACK);
+		}
+		for (const TileIndex *t = region->deferred.Begin(); t != region->deferred.End(); t++) {
+			_tile_type_procs[GetTileType(*t)]->tile_loop_proc(*t);
+		}
+	}
+}
+
 void RunTileLoop()
 {
 	TileIndex tile;
@@ -621,16 +912,21 @@ void RunTileLoop()
 	tile = _cur_tileloop_tile;
 
 	assert( (tile & ~TILELOOP_ASSERTMASK) == 0);
-	count = (MapSizeX() / TILELOOP_SIZE) * (MapSizeY() / TILELOOP_SIZE);
-	do {
-		_tile_type_procs[GetTileType(tile)]->tile_loop_proc(tile);
+	if (_patches.parallel_tile_loop && _game_mode == GM_NORMAL) {
+		/* Like the serial loop, this leaves tile at the start of the stripe */
+		RunParallelTileLoop(tile);
+	} else {
+		count = (MapSizeX() / TILELOOP_SIZE) * (MapSizeY() / TILELOOP_SIZE);
+		do {
+			_tile_type_procs[GetTileType(tile)]->tile_loop_proc(tile);
 
-		if (TileX(tile) < MapSizeX() - TILELOOP_SIZE) {
-			tile += TILELOOP_SIZE; // no overflow
-		} else {
-			tile = TILE_MASK(tile - TILELOOP_SIZE * (MapSizeX() / TILELOOP_SIZE - 1) + TileDiffXY(0, TILELOOP_SIZE)); /* x would overflow, also increase y */
-		}
-	} while (--count);
+			if (TileX(tile) < MapSizeX() - TILELOOP_SIZE) {
+				tile += TILELOOP_SIZE; // no overflow
+			} else {
+				tile = TILE_MASK(tile - TILELOOP_SIZE * (MapSizeX() / TILELOOP_SIZE - 1) + TileDiffXY(0, TILELOOP_SIZE)); /* x would overflow, also increase y */
+			}
+		} while (--count);
+	}
 	assert( (tile & ~TILELOOP_ASSERTMASK) == 0);
 
 	tile += 9;
@@ -671,7 +967,7 @@ static void GenerateTerrain(int type, int flag)
 	uint h;
 	const Sprite* templ;
 	const byte *p;
-	Tile* tile;
+	TileIndex tile;
 	byte direction;
 
 	r = Random();
@@ -720,16 +1016,16 @@ static void GenerateTerrain(int type, int flag)
 	if (x + w >= MapMaxX() - 1) return;
 	if (y + h >= MapMaxY() - 1) return;
 
-	tile = &_m[TileXY(x, y)];
+	tile = TileXY(x, y);
 
 	switch (direction) {
 		case 0:
 			do {
-				Tile* tile_cur = tile;
+				TileIndex tile_cur = tile;
 				uint w_cur;
 
 				for (w_cur = w; w_cur != 0; --w_cur) {
-					if (*p >= tile_cur->type_height) tile_cur->type_height = *p;
+					if (*p >= _m[tile_cur].type_height) _m[tile_cur].type_height = *p;
 					p++;
 					tile_cur++;
 				}
@@ -739,11 +1035,11 @@ static void GenerateTerrain(int type, int flag)
 
 		case 1:
 			do {
-				Tile* tile_cur = tile;
+				TileIndex tile_cur = tile;
 				uint h_cur;
 
 				for (h_cur = h; h_cur != 0; --h_cur) {
-					if (*p >= tile_cur->type_height) tile_cur->type_height = *p;
+					if (*p >= _m[tile_cur].type_height) _m[tile_cur].type_height = *p;
 					p++;
 					tile_cur += TileDiffXY(0, 1);
 				}
@@ -754,11 +1050,11 @@ static void GenerateTerrain(int type, int flag)
 		case 2:
 			tile += TileDiffXY(w - 1, 0);
 			do {
-				Tile* tile_cur = tile;
+				TileIndex tile_cur = tile;
 				uint w_cur;
 
 				for (w_cur = w; w_cur != 0; --w_cur) {
-					if (*p >= tile_cur->type_height) tile_cur->type_height = *p;
+					if (*p >= _m[tile_cur].type_height) _m[tile_cur].type_height = *p;
 					p++;
 					tile_cur--;
 				}
@@ -769,11 +1065,11 @@ static void GenerateTerrain(int type, int flag)
 		case 3:
 			tile += TileDiffXY(0, h - 1);
 			do {
-				Tile* tile_cur = tile;
+				TileIndex tile_cur = tile;
 				uint h_cur;
 
 				for (h_cur = h; h_cur != 0; --h_cur) {
-					if (*p >= tile_cur->type_height) tile_cur->type_height = *p;
+					if (*p >= _m[tile_cur].type_height) _m[tile_cur].type_height = *p;
 					p++;
 					tile_cur -= TileDiffXY(0, 1);
 				}
@@ -891,6 +1187,9 @@ void GenerateLandscape(byte mode)
 		}
 	}
 
+	/* The original generator writes the heights directly */
+	RebuildTileSlopeCache();
+
 	ConvertGroundTilesIntoWaterTiles();
 
 	if (_opt.landscape == LT_TROPIC) CreateDesertOrRainForest();
@@ -906,13 +1205,13 @@ void OnTick_Train();
 
 void CallLandscapeTick()
 {
-	OnTick_Town();
-	OnTick_Trees();
-	OnTick_Station();
-	OnTick_Industry();
+	RunGameLoopPhase(GLP_TOWNS, OnTick_Town);
+	RunGameLoopPhase(GLP_TREES, OnTick_Trees);
+	RunGameLoopPhase(GLP_STATIONS, OnTick_Station);
+	RunGameLoopPhase(GLP_INDUSTRIES, OnTick_Industry);
 
-	OnTick_Players();
-	OnTick_Train();
+	RunGameLoopPhase(GLP_PLAYERS, OnTick_Players);
+	RunGameLoopPhase(GLP_TRAINS, OnTick_Train);
 }
 
 TileIndex AdjustTileCoordRandomly(TileIndex a, byte rng)
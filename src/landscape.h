@@ -9,6 +9,10 @@
 #include "tile_cmd.h"
 #include "slope_type.h"
 #include "direction_type.h"
+#include "sound_type.h"
+#include "core/random_func.hpp"
+#include "misc/smallvec.h"
+#include "thread.h"
 
 enum {
 	SNOW_LINE_MONTHS = 12,
@@ -51,6 +55,37 @@ void DrawFoundation(TileInfo *ti, Foundation f);
 void DoClearSquare(TileIndex tile);
 void RunTileLoop();
 
+uint GetWorkerJobCount();
+void RunWorkerJobs(OTTDThreadFunc proc, void * const *args, uint num_jobs);
+
+/** A sound effect queued by a tile loop region. */
+struct TileLoopSound {
+	SoundFx fx;     ///< the sound to play
+	TileIndex tile; ///< the tile to play it at
+};
+
+/**
+ * State of one region (a row of the tile loop stripe) when the tile loop
+ * runs in parallel. Tiles in a region draw their randomness from the
+ * region's own randomizer and queue everything that is not local to the
+ * tile, so the outcome does not depend on the thread handling the region.
+ */
+struct TileLoopRegion {
+	Randomizer random;                    ///< random stream of this region
+	SmallVector<TileIndex, 16> dirty;     ///< tiles to mark dirty when merging
+	SmallVector<TileLoopSound, 4> sounds; ///< sounds to play when merging
+	SmallVector<TileIndex, 32> deferred;  ///< tiles that must be looped serially
+	SmallVector<TileIndex, 4> changed;    ///< tiles whose tracks changed, to notify YAPF of when merging
+};
+
+uint32 TileLoopRandom(TileLoopRegion *region);
+void TileLoopMarkDirty(TileLoopRegion *region, TileIndex tile);
+void TileLoopPlaySound(TileLoopRegion *region, SoundFx fx, TileIndex tile);
+void TileLoopNotifyTrackLayoutChange(TileLoopRegion *region, TileIndex tile);
+
+void TileLoopClear(TileIndex tile, TileLoopRegion *region);
+void TileLoopTrees(TileIndex tile, TileLoopRegion *region);
+
 void InitializeLandscape();
 void GenerateLandscape(byte mode);
 
@@ -24,9 +24,30 @@ uint _map_size_y;    ///< Size of the map along the Y
 uint _map_size;      ///< The number of tiles on the map
 uint _map_tile_mask; ///< _map_size - 1 (to mask the mapsize)
 
+#ifdef MAP_PLANES
+MapPlanes _m;             ///< Tiles of the map, one plane per member
+#elif defined(MAP_BLOCKS)
+MapBlockArray<Tile> _m;   ///< Tiles of the map
+#else
 Tile *_m = NULL;          ///< Tiles of the map
+#endif /* MAP_PLANES */
+#ifdef MAP_BLOCKS
+MapBlockArray<TileExtended> _me; ///< Extended Tiles of the map
+#else
 TileExtended *_me = NULL; ///< Extended Tiles of the map
+#endif /* MAP_BLOCKS */
+uint16 *_map_slope = NULL; ///< Cached slope and lowest height of the tiles of the map
+
 
+/**
+ * Get the amount of memory the tile arrays of a map take.
+ * @param tiles the number of tiles of the map
+ * @return the size of the tile arrays in bytes
+ */
+size_t GetMapMemoryUsage(uint tiles)
+{
+	return tiles * (sizeof(Tile) + sizeof(TileExtended) + sizeof(*_map_slope));
+}
 
 /*!
  * (Re)allocates a map with the given dimension
@@ -37,13 +58,13 @@ void AllocateMap(uint size_x, uint size_y)
 {
 	/* Make sure that the map size is within the limits and that
 	 * the x axis size is a power of 2. */
-	if (size_x < 64 || size_x > 2048 ||
-			size_y < 64 || size_y > 2048 ||
+	if (size_x < MIN_MAP_SIZE || size_x > MAX_MAP_SIZE ||
+			size_y < MIN_MAP_SIZE || size_y > MAX_MAP_SIZE ||
 			(size_x & (size_x - 1)) != 0 ||
 			(size_y & (size_y - 1)) != 0)
 		error("Invalid map size");
 
-	DEBUG(map, 1, "Allocating map of size %dx%d", size_x, size_y);
+	DEBUG(map, 1, "Allocating map of size %dx%d (%u KiB)", size_x, size_y, (uint)(GetMapMemoryUsage(size_x * size_y) / 1024));
 
 	_map_log_x = FindFirstBit(size_x);
 	_map_log_y = FindFirstBit(size_y);
@@ -52,16 +73,47 @@ void AllocateMap(uint size_x, uint size_y)
 	_map_size = size_x * size_y;
 	_map_tile_mask = _map_size - 1;
 
+#ifdef MAP_PLANES
+	free(_m.m2);
+#elif defined(MAP_BLOCKS)
+	free(_m.data);
+#else
 	free(_m);
+#endif /* MAP_PLANES */
+#ifdef MAP_BLOCKS
+	free(_me.data);
+#else
 	free(_me);
+#endif /* MAP_BLOCKS */
+	free(_map_slope);
 
 	/* XXX @todo handle memory shortage more gracefully
 	 * CallocT does the out-of-memory check
 	 * Maybe some attemps could be made to try with smaller maps down to 64x64
 	 * Maybe check for available memory before doing the calls, after all, we know how big
 	 * the map is */
+#ifdef MAP_PLANES
+	/* All planes share one block, the 16 bits plane first to keep it aligned */
+	byte *planes = CallocT<byte>(_map_size * sizeof(Tile));
+	_m.m2          = (uint16*)planes; planes += _map_size * sizeof(*_m.m2);
+	_m.type_height = planes;          planes += _map_size;
+	_m.m1          = planes;          planes += _map_size;
+	_m.m3          = planes;          planes += _map_size;
+	_m.m4          = planes;          planes += _map_size;
+	_m.m5          = planes;          planes += _map_size;
+	_m.m6          = planes;
+#elif defined(MAP_BLOCKS)
+	_m.data = CallocT<Tile>(_map_size);
+#else
 	_m = CallocT<Tile>(_map_size);
+#endif /* MAP_PLANES */
+#ifdef MAP_BLOCKS
+	_me.data = CallocT<TileExtended>(_map_size);
+#else
 	_me = CallocT<TileExtended>(_map_size);
+#endif /* MAP_BLOCKS */
+	/* A cleared map is flat at height 0, which is what a zeroed cache says */
+	_map_slope = CallocT<uint16>(_map_size);
 }
 
 
@@ -24,6 +24,90 @@ extern uint _map_tile_mask;
  */
 #define TILE_ASSERT(x) assert(TILE_MASK(x) == (x));
 
+#ifdef MAP_BLOCKS
+static const uint MAP_BLOCK_BITS = 3;                        ///< Tiles are stored in blocks of 2 ^ MAP_BLOCK_BITS tiles square
+static const uint MAP_BLOCK_MASK = (1 << MAP_BLOCK_BITS) - 1; ///< Mask of the coordinates within a block
+
+/**
+ * Get the position of a tile in the map arrays. With MAP_BLOCKS the map is
+ * stored in square blocks of 8x8 tiles, so the neighbours of a tile in
+ * the Y direction usually are in the same block instead of a whole map
+ * row away. TileIndex itself, and thus all arithmetic on it and the
+ * savegame format, stays row-major.
+ * @param tile the tile to get the position of
+ * @return the index into the map arrays
+ */
+static inline uint GetTileStorageIndex(TileIndex tile)
+{
+	extern uint _map_log_x;
+	extern uint _map_size_x;
+
+	uint x = tile & (_map_size_x - 1);
+	uint y = tile >> _map_log_x;
+	return ((y & ~MAP_BLOCK_MASK) << _map_log_x) |
+			((x & ~MAP_BLOCK_MASK) << MAP_BLOCK_BITS) |
+			((y & MAP_BLOCK_MASK) << MAP_BLOCK_BITS) |
+			(x & MAP_BLOCK_MASK);
+}
+
+/**
+ * An array with an element per tile, stored in blocks; indexing it with a
+ * TileIndex goes through GetTileStorageIndex.
+ */
+template <typename T>
+struct MapBlockArray {
+	T *data; ///< The elements, in storage order
+
+	inline T &operator[](TileIndex tile) const
+	{
+		return this->data[GetTileStorageIndex(tile)];
+	}
+};
+#else
+/**
+ * Get the position of a tile in the map arrays.
+ * @param tile the tile to get the position of
+ * @return the index into the map arrays
+ */
+static inline uint GetTileStorageIndex(TileIndex tile)
+{
+	return tile;
+}
+#endif /* MAP_BLOCKS */
+
+#ifdef MAP_PLANES
+/**
+ * The tiles of the map with every member of Tile stored in its own array,
+ * so scans over a single member only touch that member's memory.
+ * Indexing it gives a TileRef, so _m[tile].m5 works like it does for the
+ * tile-array.
+ */
+struct MapPlanes {
+	byte   *type_height; ///< Plane of Tile::type_height
+	byte   *m1;          ///< Plane of Tile::m1
+	uint16 *m2;          ///< Plane of Tile::m2
+	byte   *m3;          ///< Plane of Tile::m3
+	byte   *m4;          ///< Plane of Tile::m4
+	byte   *m5;          ///< Plane of Tile::m5
+	byte   *m6;          ///< Plane of Tile::m6
+
+	inline TileRef operator[](TileIndex tile) const
+	{
+		uint i = GetTileStorageIndex(tile);
+		TileRef ref = {
+			this->type_height[i], this->m1[i], this->m2[i],
+			this->m3[i], this->m4[i], this->m5[i], this->m6[i]
+		};
+		return ref;
+	}
+};
+
+/** The planes of the map; see MapPlanes. */
+extern MapPlanes _m;
+#elif defined(MAP_BLOCKS)
+/** The tile-array, stored in blocks; see GetTileStorageIndex. */
+extern MapBlockArray<Tile> _m;
+#else
 /**
  * Pointer to the tile-array.
  *
@@ -31,7 +115,12 @@ extern uint _map_tile_mask;
  * the map.
  */
 extern Tile *_m;
+#endif /* MAP_PLANES */
 
+#ifdef MAP_BLOCKS
+/** The extended tile-array, stored in blocks; see GetTileStorageIndex. */
+extern MapBlockArray<TileExtended> _me;
+#else
 /**
  * Pointer to the extended tile-array.
  *
@@ -39,11 +128,19 @@ extern Tile *_m;
  * of the map.
  */
 extern TileExtended *_me;
+#endif /* MAP_BLOCKS */
+
+/**
+ * Cached slope (bits 0..7) and height of the lowest corner (bits 8..11) of
+ * every tile, indexed by TileIndex; see GetTileSlope.
+ */
+extern uint16 *_map_slope;
 
 /**
  * Allocate a new map with the given size.
  */
 void AllocateMap(uint size_x, uint size_y);
+size_t GetMapMemoryUsage(uint tiles);
 
 /**
  * Logarithm of the map size along the X side.
@@ -19,6 +19,23 @@ struct Tile {
 	byte   m6;          ///< Primarily used for bridges and rainforest/desert
 };
 
+#ifdef MAP_PLANES
+/**
+ * The members of a single tile when the map is stored as planes.
+ * The members are references into the planes, so this has the same
+ * interface as Tile; see MapPlanes.
+ */
+struct TileRef {
+	byte   &type_height; ///< The type (bits 4..7) and height of the northern corner
+	byte   &m1;          ///< Primarily used for ownership information
+	uint16 &m2;          ///< Primarily used for indices to towns, industries and stations
+	byte   &m3;          ///< General purpose
+	byte   &m4;          ///< General purpose
+	byte   &m5;          ///< General purpose
+	byte   &m6;          ///< Primarily used for bridges and rainforest/desert
+};
+#endif /* MAP_PLANES */
+
 /**
  * Data that is stored per tile. Also used Tile for this.
  * Look at docs/landscape.html for the exact meaning of the members.
@@ -27,6 +44,11 @@ struct TileExtended {
 	byte m7; ///< Primarily used for newgrf support
 };
 
+static const uint MIN_MAP_SIZE_BITS = 6;                      ///< Minimal size of map is equal to 2 ^ MIN_MAP_SIZE_BITS
+static const uint MAX_MAP_SIZE_BITS = 13;                     ///< Maximal size of map is equal to 2 ^ MAX_MAP_SIZE_BITS
+static const uint MIN_MAP_SIZE      = 1 << MIN_MAP_SIZE_BITS; ///< Minimal map size = 64
+static const uint MAX_MAP_SIZE      = 1 << MAX_MAP_SIZE_BITS; ///< Maximal map size = 8192
+
 /**
  * An offset value between to tiles.
  *
@@ -0,0 +1,57 @@
+/* $Id$ */
+
+/** @file meminfo.cpp Accounting of the memory used by the parts of the game. */
+
+#include "stdafx.h"
+#include "openttd.h"
+#include "meminfo.h"
+#include "map_func.h"
+#include "oldpool.h"
+#include "spritecache.h"
+#include "fontcache.h"
+#include "network/network.h"
+#include "direction_type.h"
+#include "track_type.h"
+#include "vehicle_type.h"
+#include "vehicle_func.h"
+#include "yapf/yapf.h"
+
+#include "safeguards.h"
+
+/**
+ * Get the memory used by the map, all pools and the caches.
+ * @param usage array to store the memory usage of each part in
+ * @param max   the number of entries in usage
+ * @return the number of entries that were filled
+ */
+uint GetMemoryUsage(MemoryUsage *usage, uint max)
+{
+	uint n = 0;
+
+	if (n < max) {
+		usage[n].name = "map";
+		usage[n].allocated = GetMapMemoryUsage(MapSize());
+		usage[n].used = usage[n].allocated;
+		usage[n].items = MapSize();
+		usage[n].capacity = MapSize();
+		usage[n].peak = 0;
+		n++;
+	}
+
+	for (const OldMemoryPoolBase *pool = OldMemoryPoolBase::first_pool; pool != NULL && n < max; pool = pool->next_pool) {
+		pool->GetMemoryUsage(&usage[n++]);
+	}
+
+	if (n < max) GetVehiclePosHashMemoryUsage(&usage[n++]);
+	if (n < max) GetViewportVehicleHashMemoryUsage(&usage[n++]);
+	if (n < max) GetSpriteCacheMemoryUsage(&usage[n++]);
+	if (n < max) GetFontCacheMemoryUsage(&usage[n++]);
+	if (n < max) YapfGetMemoryUsage(&usage[n++]);
+	if (n < max) YapfGetNodeListMemoryUsage(&usage[n++]);
+	if (n < max) YapfGetRegionMemoryUsage(&usage[n++]);
+#ifdef ENABLE_NETWORK
+	if (n < max) NetworkGetMemoryUsage(&usage[n++]);
+#endif /* ENABLE_NETWORK */
+
+	return n;
+}
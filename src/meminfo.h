@@ -0,0 +1,23 @@
+/* $Id$ */
+
+/** @file meminfo.h Accounting of the memory used by the parts of the game. */
+
+#ifndef MEMINFO_H
+#define MEMINFO_H
+
+/** Memory used by one part of the game. */
+struct MemoryUsage {
+	const char *name; ///< Name of the part, without spaces so it can be used as key.
+	uint64 allocated; ///< Bytes allocated for this part.
+	uint64 used;      ///< Bytes of the allocated memory that hold something.
+	uint items;       ///< Number of items in use.
+	uint capacity;    ///< Number of items that fit in the allocated memory.
+	uint peak;        ///< Highest number of items in use since the start, 0 when not tracked.
+};
+
+/** Maximum number of parts GetMemoryUsage() reports. */
+static const uint MAX_MEMORY_USAGE = 32;
+
+uint GetMemoryUsage(MemoryUsage *usage, uint max);
+
+#endif /* MEMINFO_H */
@@ -26,6 +26,8 @@
 #include "string_func.h"
 #include "gfx_func.h"
 #include "core/alloc_func.hpp"
+#include "track_type.h"
+#include "yapf/yapf.h"
 
 #include "table/strings.h"
 #include "table/sprites.h"
@@ -64,6 +66,9 @@ void InitializeGame(int mode, uint size_x, uint size_y)
 {
 	AllocateMap(size_x, size_y);
 
+	/* Segments cached by the pathfinder belong to the previous map */
+	YapfNotifyTrackLayoutChange(INVALID_TILE, INVALID_TRACK);
+
 	SetObjectToPlace(SPR_CURSOR_ZZZ, PAL_NONE, VHM_NONE, WC_MAIN_WINDOW, 0);
 
 	_pause_game = 0;
@@ -167,8 +167,8 @@ public:
 	/** item count */
 	FORCEINLINE int Count() const {return m_num_items;}
 
-	/** simple clear - forget all items - used by CSegmentCostCacheT.Flush() */
-	FORCEINLINE void Clear() const {for (int i = 0; i < Tcapacity; i++) m_slots[i].Clear();}
+	/** simple clear - forget all items - used by CSegmentCostCacheT.Flush() and CNodeList_HashTableT */
+	FORCEINLINE void Clear() {for (int i = 0; i < Tcapacity; i++) m_slots[i].Clear(); m_num_items = 0;}
 
 	/** const item search */
 	const Titem_* Find(const Tkey& key) const
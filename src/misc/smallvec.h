@@ -57,6 +57,16 @@ struct SmallVector {
 		return &this->data[this->items++];
 	}
 
+	/**
+	 * Remove an item; the last item takes its place.
+	 * @param item the item to remove
+	 */
+	void Erase(T *item)
+	{
+		assert(item >= this->Begin() && item < this->End());
+		*item = this->data[--this->items];
+	}
+
 	/**
 	 * Get the number of items in the list.
 	 */
@@ -19,6 +19,9 @@
 
 #include "../../safeguards.h"
 
+uint NetworkTCPSocketHandler::queued_packets = 0;
+uint NetworkTCPSocketHandler::queued_packets_peak = 0;
+
 /** Very ugly temporary hack !!! */
 void NetworkTCPSocketHandler::Initialize()
 {
@@ -50,6 +53,7 @@ void NetworkTCPSocketHandler::Destroy()
 		Packet *p = this->packet_queue->next;
 		delete this->packet_queue;
 		this->packet_queue = p;
+		queued_packets--;
 	}
 	delete this->packet_recv;
 	this->packet_recv = NULL;
@@ -98,6 +102,9 @@ void NetworkTCPSocketHandler::Send_Packet(Packet *packet)
 
 	packet->PrepareToSend();
 
+	queued_packets++;
+	queued_packets_peak = max(queued_packets_peak, queued_packets);
+
 	/* Locate last packet buffered for the client */
 	p = this->packet_queue;
 	if (p == NULL) {
@@ -153,6 +160,7 @@ bool NetworkTCPSocketHandler::Send_Packets()
 			this->packet_queue = p->next;
 			delete p;
 			p = this->packet_queue;
+			queued_packets--;
 		} else {
 			return true;
 		}
@@ -250,5 +258,16 @@ bool NetworkTCPSocketHandler::IsPacketQueueEmpty()
 	return this->packet_queue == NULL;
 }
 
+/**
+ * Get the number of bytes that are waiting to be sent.
+ * @return the bytes in the packet queue that have not been sent yet
+ */
+uint NetworkTCPSocketHandler::GetQueuedBytes() const
+{
+	uint bytes = 0;
+	for (const Packet *p = this->packet_queue; p != NULL; p = p->next) bytes += p->size - p->pos;
+	return bytes;
+}
+
 
 #endif /* ENABLE_NETWORK */
@@ -108,6 +108,10 @@ public:
 	void Send_Packet(Packet *packet);
 	bool Send_Packets();
 	bool IsPacketQueueEmpty();
+	uint GetQueuedBytes() const;
+
+	static uint queued_packets;      ///< Number of packets waiting to be sent on all sockets
+	static uint queued_packets_peak; ///< Highest number of packets that were waiting at once
 
 	Packet *Recv_Packet(NetworkRecvStatus *status);
 };
@@ -32,6 +32,7 @@
 #include "../player_func.h"
 #include "../settings_type.h"
 #include "../rev.h"
+#include "../meminfo.h"
 #ifdef DEBUG_DUMP_COMMANDS
 	#include "../core/alloc_func.hpp"
 #endif /* DEBUG_DUMP_COMMANDS */
@@ -138,6 +139,23 @@ byte NetworkSpectatorCount()
 	return count;
 }
 
+/**
+ * Get the memory the packets waiting to be sent to the clients take.
+ * @param usage the place to store the memory usage in
+ */
+void NetworkGetMemoryUsage(MemoryUsage *usage)
+{
+	NetworkTCPSocketHandler *cs;
+
+	usage->name = "network_queue";
+	usage->items = NetworkTCPSocketHandler::queued_packets;
+	usage->capacity = usage->items;
+	usage->peak = NetworkTCPSocketHandler::queued_packets_peak;
+	usage->allocated = (uint64)usage->items * sizeof(Packet);
+	usage->used = 0;
+	FOR_ALL_CLIENTS(cs) usage->used += cs->GetQueuedBytes();
+}
+
 // This puts a text-message to the console, or in the future, the chat-box,
 //  (to keep it all a bit more general)
 // If 'self_send' is true, this is the client who is sending the message
@@ -1285,6 +1303,59 @@ void NetworkUDPGameLoop()
 	}
 }
 
+/**
+ * Add all sockets data can arrive on to a set, so the caller can wait
+ * until there is something for the network to handle.
+ * @param read_fd the set to add the sockets to
+ * @return whether any socket has been added
+ */
+bool NetworkAddSocketsToSet(fd_set *read_fd)
+{
+	bool added = false;
+
+	if (_networking) {
+		NetworkTCPSocketHandler *cs;
+		FOR_ALL_CLIENTS(cs) {
+			FD_SET(cs->sock, read_fd);
+			added = true;
+		}
+
+		if (_network_server) {
+			FD_SET(_listensocket, read_fd);
+			added = true;
+		}
+	}
+
+	if (_network_udp_server) {
+		if (_udp_server_socket->IsConnected()) {
+			FD_SET(_udp_server_socket->sock, read_fd);
+			added = true;
+		}
+		if (_udp_master_socket->IsConnected()) {
+			FD_SET(_udp_master_socket->sock, read_fd);
+			added = true;
+		}
+	}
+
+	return added;
+}
+
+/**
+ * Handle everything that arrived on the sockets, without running a game
+ * tick. This way packets are not left waiting until the next tick.
+ */
+void NetworkHandleIncoming()
+{
+	if (_network_udp_server) {
+		_udp_server_socket->ReceivePackets();
+		_udp_master_socket->ReceivePackets();
+	}
+
+	if (!_networking) return;
+
+	if (NetworkReceive()) NetworkSend();
+}
+
 // The main loop called from ttd.c
 //  Here we also have to do StateGameLoop if needed!
 void NetworkGameLoop()
@@ -9,6 +9,7 @@
 
 void NetworkStartUp();
 void NetworkShutDown();
+void NetworkGetMemoryUsage(struct MemoryUsage *usage);
 
 extern bool _networking;         ///< are we in networking mode?
 extern bool _network_server;     ///< network-server is active
@@ -7,6 +7,7 @@
 
 #include "../player_type.h"
 #include "../economy_type.h"
+#include "core/os_abstraction.h"
 #include "core/config.h"
 #include "core/game.h"
 
@@ -197,6 +198,8 @@ void NetworkStartDebugLog(const char *hostname, uint16 port);
 void NetworkUDPCloseAll();
 void NetworkGameLoop();
 void NetworkUDPGameLoop();
+bool NetworkAddSocketsToSet(fd_set *read_fd);
+void NetworkHandleIncoming();
 bool NetworkServerStart();
 bool NetworkClientConnectGame(const char *host, uint16 port);
 void NetworkReboot();
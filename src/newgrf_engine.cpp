@@ -668,7 +668,7 @@ static uint32 VehicleGetVariable(const ResolverObject *object, byte variable, by
 		case 0x14: return v->service_interval;
 		case 0x15: return GB(v->service_interval, 8, 8);
 		case 0x16: return v->last_station_visited;
-		case 0x17: return v->tick_counter;
+		case 0x17: return GetVehicleTickCounter(v);
 		case 0x18: return v->max_speed;
 		case 0x19: return GB(v->max_speed, 8, 8);
 		case 0x1A: return v->x_pos;
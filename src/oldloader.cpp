@@ -397,6 +397,7 @@ static void FixOldVehicles()
 
 extern TileIndex *_animated_tile_list;
 extern uint _animated_tile_count;
+extern void RebuildAnimatedTileHash();
 extern char _name_array[512][32];
 
 static byte   _old_vehicle_multiplier;
@@ -542,6 +543,7 @@ static bool LoadOldAnimTileList(LoadgameState *ls, int num)
 	for (_animated_tile_count = 0; _animated_tile_count < 256; _animated_tile_count++) {
 		if (_animated_tile_list[_animated_tile_count] == 0) break;
 	}
+	RebuildAnimatedTileHash();
 
 	return true;
 }
@@ -6,8 +6,11 @@
 #include "openttd.h"
 #include "debug.h"
 #include "oldpool.h"
+#include "meminfo.h"
 #include "core/alloc_func.hpp"
 
+OldMemoryPoolBase *OldMemoryPoolBase::first_pool = NULL;
+
 /**
  * Clean a pool in a safe way (does free all blocks)
  */
@@ -29,11 +32,14 @@ void OldMemoryPoolBase::CleanPool()
 
 	/* Free the block itself */
 	free(this->blocks);
+	free(this->live);
 
 	/* Clear up some critical data */
 	this->total_items = 0;
 	this->current_blocks = 0;
 	this->blocks = NULL;
+	this->live = NULL;
+	this->live_items = 0;
 	this->first_free_index = 0;
 }
 
@@ -61,6 +67,14 @@ bool OldMemoryPoolBase::AddBlockToPool()
 	/* Clean the content of the new block */
 	memset(this->blocks[this->current_blocks], 0, this->item_size * (1 << this->block_size_bits));
 
+	/* None of the new items are live yet */
+	if (this->track_live) {
+		uint old_words = (this->current_blocks * (1 << this->block_size_bits) + 31) / 32;
+		uint new_words = (this->total_items + 31) / 32;
+		this->live = ReallocT(this->live, new_words);
+		memset(this->live + old_words, 0, (new_words - old_words) * sizeof(*this->live));
+	}
+
 	/* Call a custom function if defined (e.g. to fill indexes) */
 	if (this->new_block_proc != NULL) this->new_block_proc(this->current_blocks * (1 << this->block_size_bits));
 
@@ -83,3 +97,24 @@ bool OldMemoryPoolBase::AddBlockIfNeeded(uint index)
 
 	return true;
 }
+
+/**
+ * Get the memory this pool takes.
+ * @param usage the place to store the memory usage in
+ */
+void OldMemoryPoolBase::GetMemoryUsage(MemoryUsage *usage) const
+{
+	usage->name = this->name;
+	usage->capacity = this->total_items;
+	usage->allocated = (uint64)this->total_items * this->item_size + this->current_blocks * sizeof(*this->blocks);
+	if (this->track_live) {
+		usage->allocated += (this->total_items + 31) / 32 * sizeof(*this->live);
+		usage->items = this->live_items;
+		usage->peak = this->peak_live_items;
+	} else {
+		/* These pools are filled from the start and emptied as a whole */
+		usage->items = this->total_items;
+		usage->peak = 0;
+	}
+	usage->used = (uint64)usage->items * this->item_size;
+}
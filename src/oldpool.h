@@ -6,6 +6,9 @@
 #define OLDPOOL_H
 
 #include "core/math_func.hpp"
+#include "core/bitmath_func.hpp"
+
+struct MemoryUsage;
 
 /* The function that is called after a new block is added
      start_item is the first item of the new made block */
@@ -21,13 +24,20 @@ struct OldMemoryPoolBase {
 	void CleanPool();
 	bool AddBlockToPool();
 	bool AddBlockIfNeeded(uint index);
+	void GetMemoryUsage(MemoryUsage *usage) const;
+
+	static OldMemoryPoolBase *first_pool; ///< First of all pools, linked via next_pool
 
 protected:
 	OldMemoryPoolBase(const char *name, uint max_blocks, uint block_size_bits, uint item_size,
-				OldMemoryPoolNewBlock *new_block_proc, OldMemoryPoolCleanBlock *clean_block_proc) :
+				OldMemoryPoolNewBlock *new_block_proc, OldMemoryPoolCleanBlock *clean_block_proc, bool track_live) :
 		name(name), max_blocks(max_blocks), block_size_bits(block_size_bits),
 		new_block_proc(new_block_proc), clean_block_proc(clean_block_proc), current_blocks(0),
-		total_items(0), cleaning_pool(false), item_size(item_size), first_free_index(0), blocks(NULL) {}
+		total_items(0), cleaning_pool(false), track_live(track_live), live_items(0), peak_live_items(0),
+		next_pool(first_pool), item_size(item_size), first_free_index(0), blocks(NULL), live(NULL)
+	{
+		first_pool = this;
+	}
 
 	const char* name;     ///< Name of the pool (just for debugging)
 
@@ -43,10 +53,16 @@ protected:
 	uint total_items;           ///< How many items we now have in this pool
 
 	bool cleaning_pool;         ///< Are we currently cleaning the pool?
+
+	const bool track_live;      ///< Whether the items are PoolItems, which keep the live bitmap up to date
+	uint live_items;            ///< Number of items marked live
+	uint peak_live_items;       ///< Highest number of items that were marked live at once
 public:
+	OldMemoryPoolBase *next_pool; ///< Next pool in the list of all pools
 	const uint item_size;       ///< How many bytes one block is
 	uint first_free_index;      ///< The index of the first free pool item in this pool
 	byte **blocks;              ///< An array of blocks (one block hold all the items)
+	uint32 *live;               ///< Bitmap of the items that may be in use; items with a cleared bit are never valid
 
 	/**
 	 * Check if the index of pool item being deleted is lower than cached first_free_index
@@ -58,6 +74,59 @@ public:
 		first_free_index = min(first_free_index, index);
 	}
 
+	/**
+	 * Mark a pool item as possibly being in use.
+	 * @param index index of pool item
+	 */
+	inline void SetLive(uint index)
+	{
+		if (HasBit(this->live[index / 32], index % 32)) return;
+		SetBit(this->live[index / 32], index % 32);
+		this->live_items++;
+		this->peak_live_items = max(this->peak_live_items, this->live_items);
+	}
+
+	/**
+	 * Mark a pool item as free, i.e. it is not valid anymore.
+	 * @param index index of pool item
+	 */
+	inline void ClearLive(uint index)
+	{
+		if (!HasBit(this->live[index / 32], index % 32)) return;
+		ClrBit(this->live[index / 32], index % 32);
+		this->live_items--;
+	}
+
+	/**
+	 * Can the pool item be in use? When not, it is certainly invalid.
+	 * @param index index of pool item
+	 * @pre index < this->GetSize()
+	 * @return true if the item was allocated and not freed since
+	 */
+	inline bool IsLive(uint index) const
+	{
+		return HasBit(this->live[index / 32], index % 32);
+	}
+
+	/**
+	 * Find the first pool item at or after the given index that may be in
+	 * use, skipping runs of free items a whole word at a time.
+	 * @param index the index to start searching at
+	 * @return the index of the item, or GetSize() when there is none
+	 */
+	inline uint GetNextLiveIndex(uint index) const
+	{
+		if (index >= this->total_items) return this->total_items;
+
+		uint word = index / 32;
+		uint32 bits = this->live[word] & (~0U << (index % 32));
+		while (bits == 0) {
+			if (++word * 32 >= this->total_items) return this->total_items;
+			bits = this->live[word];
+		}
+		return word * 32 + FindFirstBit(bits);
+	}
+
 	/**
 	 * Get the size of this pool, i.e. the total number of items you
 	 * can put into it at the current moment; the pool might still
@@ -111,8 +180,8 @@ public:
 template <typename T>
 struct OldMemoryPool : public OldMemoryPoolBase {
 	OldMemoryPool(const char *name, uint max_blocks, uint block_size_bits, uint item_size,
-				OldMemoryPoolNewBlock *new_block_proc, OldMemoryPoolCleanBlock *clean_block_proc) :
-		OldMemoryPoolBase(name, max_blocks, block_size_bits, item_size, new_block_proc, clean_block_proc) {}
+				OldMemoryPoolNewBlock *new_block_proc, OldMemoryPoolCleanBlock *clean_block_proc, bool track_live) :
+		OldMemoryPoolBase(name, max_blocks, block_size_bits, item_size, new_block_proc, clean_block_proc, track_live) {}
 
 	/**
 	 * Get the pool entry at the given index.
@@ -126,6 +195,19 @@ struct OldMemoryPool : public OldMemoryPoolBase {
 		return (T*)(this->blocks[index >> this->block_size_bits] +
 				(index & ((1 << this->block_size_bits) - 1)) * this->item_size);
 	}
+
+	/**
+	 * Get the first pool entry at or after the given index that may be in use.
+	 * This is what the FOR_ALL_* macros iterate with; they still have to
+	 * check the validity of the entry.
+	 * @param index the index to start searching at
+	 * @return the pool entry, or NULL when there is none
+	 */
+	inline T *GetNextLive(uint index) const
+	{
+		index = this->GetNextLiveIndex(index);
+		return index < this->GetSize() ? this->Get(index) : NULL;
+	}
 };
 
 /**
@@ -204,10 +286,11 @@ struct PoolItem {
 	/**
 	 * 'Free' the memory allocated by the overriden new.
 	 * @param p the memory to 'free'
-	 * @note we only update Tpool->first_free_index
+	 * @note we only update Tpool->first_free_index and the live bitmap
 	 */
 	void operator delete(void *p)
 	{
+		Tpool->ClearLive(((T*)p)->index);
 		Tpool->UpdateFirstFreeIndex(((T*)p)->index);
 	}
 
@@ -222,6 +305,7 @@ struct PoolItem {
 	{
 		if (!Tpool->AddBlockIfNeeded(index)) error("%s: failed loading savegame: too many %s", Tpool->GetName(), Tpool->GetName());
 
+		Tpool->SetLive(index);
 		return Tpool->Get(index);
 	}
 
@@ -229,10 +313,11 @@ struct PoolItem {
 	 * 'Free' the memory allocated by the overriden new.
 	 * @param p     the memory to 'free'
 	 * @param index the original parameter given to create the memory
-	 * @note we only update Tpool->first_free_index
+	 * @note we only update Tpool->first_free_index and the live bitmap
 	 */
 	void operator delete(void *p, int index)
 	{
+		Tpool->ClearLive(index);
 		Tpool->UpdateFirstFreeIndex(index);
 	}
 
@@ -268,17 +353,18 @@ private:
 	 */
 	static inline T *AllocateSafeRaw(uint &first)
 	{
-		uint last_minus_one = Tpool->GetSize() - 1;
-
-		for (T *t = Tpool->Get(first); t != NULL; t = (t->index < last_minus_one) ? Tpool->Get(t->index + 1U) : NULL) {
-			if (!t->IsValid()) {
-				first = t->index;
-				Tid index = t->index;
-
-				memset(t, 0, Tpool->item_size);
-				t->index = index;
-				return t;
-			}
+		/* The first invalid item is taken, so which item we get does not
+		 * depend on the order in which items were freed. Items that are not
+		 * live are known to be invalid without looking at them. */
+		for (uint index = first; index < Tpool->GetSize(); index++) {
+			if (Tpool->IsLive(index) && Tpool->Get(index)->IsValid()) continue;
+
+			T *t = Tpool->Get(index);
+			first = index;
+			memset(t, 0, Tpool->item_size);
+			t->index = index;
+			Tpool->SetLive(index);
+			return t;
 		}
 
 		/* Check if we can add a block to the pool */
@@ -327,11 +413,9 @@ public:
 	 */
 	static inline bool CanAllocateItem()
 	{
-		uint last_minus_one = Tpool->GetSize() - 1;
-
-		for (T *t = Tpool->Get(Tpool->first_free_index); t != NULL; t = (t->index < last_minus_one) ? Tpool->Get(t->index + 1U) : NULL) {
-			if (!t->IsValid()) return true;
-			Tpool->first_free_index = t->index;
+		for (uint index = Tpool->first_free_index; index < Tpool->GetSize(); index++) {
+			if (!Tpool->IsLive(index) || !Tpool->Get(index)->IsValid()) return true;
+			Tpool->first_free_index = index;
 		}
 
 		/* Check if we can add a block to the pool */
@@ -360,15 +444,16 @@ public:
 	OLD_POOL_ACCESSORS(name, type)
 
 
+/* Pools of plain data do not keep track of which items are in use */
 #define DEFINE_OLD_POOL(name, type, new_block_proc, clean_block_proc) \
 	OldMemoryPool<type> _##name##_pool( \
 		#name, name##_POOL_MAX_BLOCKS, name##_POOL_BLOCK_SIZE_BITS, sizeof(type), \
-		new_block_proc, clean_block_proc);
+		new_block_proc, clean_block_proc, false);
 
 #define DEFINE_OLD_POOL_GENERIC(name, type) \
 	OldMemoryPool<type> _##name##_pool( \
 		#name, name##_POOL_MAX_BLOCKS, name##_POOL_BLOCK_SIZE_BITS, sizeof(type), \
-		PoolNewBlock<type, &_##name##_pool>, PoolCleanBlock<type, &_##name##_pool>);
+		PoolNewBlock<type, &_##name##_pool>, PoolCleanBlock<type, &_##name##_pool>, true);
 
 
 #define STATIC_OLD_POOL(name, type, block_size_bits, max_blocks, new_block_proc, clean_block_proc) \
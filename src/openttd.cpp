@@ -67,6 +67,7 @@
 #include "variables.h"
 #include "road_func.h"
 #include "rev.h"
+#include "profiler.h"
 
 #include "bridge_map.h"
 #include "clear_map.h"
@@ -163,7 +164,9 @@ static void ShowHelp()
 		"  -i                  = Force to use the DOS palette\n"
 		"                          (use this if you see a lot of pink)\n"
 		"  -c config_file      = Use 'config_file' instead of 'openttd.cfg'\n"
-		"  -x                  = Do not automatically save to config file on exit\n",
+		"  -x                  = Do not automatically save to config file on exit\n"
+		"  -F                  = Fast forward every game; the dedicated and null\n"
+		"                          video drivers then run as fast as possible\n",
 		lastof(buf)
 	);
 
@@ -328,6 +331,8 @@ static void LoadIntroGame()
 
 byte _no_scroll;
 byte _savegame_sort_order;
+/** Whether every game is fast forwarded as soon as it is started (command line option -F). */
+static bool _fast_forward_games;
 #if defined(UNIX) && !defined(__MORPHOS__)
 extern void DedicatedFork();
 #endif
@@ -362,7 +367,7 @@ int ttd_main(int argc, char *argv[])
 	 *   a letter means: it accepts that param (e.g.: -h)
 	 *   a ':' behind it means: it need a param (e.g.: -m<driver>)
 	 *   a '::' behind it means: it can optional have a param (e.g.: -d<debug>) */
-	optformat = "m:s:v:b:hD::n::eit:d::r:g::G:c:xl:"
+	optformat = "m:s:v:b:hD::n::eit:d::r:g::G:c:xl:F"
 #if !defined(__MORPHOS__) && !defined(__AMIGA__) && !defined(WIN32)
 		"f"
 #endif
@@ -437,6 +442,7 @@ int ttd_main(int argc, char *argv[])
 		case 'G': generation_seed = atoi(mgo.opt); break;
 		case 'c': _config_file = strdup(mgo.opt); break;
 		case 'x': save_config = false; break;
+		case 'F': _fast_forward_games = true; break;
 		case -2:
 		case 'h':
 			ShowHelp();
@@ -978,6 +984,11 @@ void SwitchMode(int new_mode)
 		break;
 	}
 
+	/* Loading or starting a game stops fast forwarding, unless asked otherwise */
+	if (_fast_forward_games && (new_mode == SM_NEWGAME || new_mode == SM_LOAD_GAME || new_mode == SM_START_SCENARIO || new_mode == SM_START_HEIGHTMAP)) {
+		_fast_forward = 1;
+	}
+
 	if (_switch_mode_errorstr != INVALID_STRING_ID) {
 		ShowErrorMessage(INVALID_STRING_ID, _switch_mode_errorstr, 0, 0);
 	}
@@ -990,6 +1001,8 @@ void SwitchMode(int new_mode)
  * That check is enforced in DoCommand. */
 void StateGameLoop()
 {
+	memset(_game_loop_phase_time, 0, sizeof(_game_loop_phase_time));
+
 	/* dont execute the state loop during pause */
 	if (_pause_game) {
 		CallWindowTickEvent();
@@ -997,12 +1010,14 @@ void StateGameLoop()
 	}
 	if (IsGeneratingWorld()) return;
 
+	uint64 start = GetTimeMicroseconds();
+
 	ClearStorageChanges(false);
 
 	if (_game_mode == GM_EDITOR) {
-		RunTileLoop();
-		CallVehicleTicks();
-		CallLandscapeTick();
+		RunGameLoopPhase(GLP_TILE_LOOP, RunTileLoop);
+		RunGameLoopPhase(GLP_VEHICLES, CallVehicleTicks);
+		RunGameLoopPhase(GLP_LANDSCAPE, CallLandscapeTick);
 		ClearStorageChanges(true);
 
 		CallWindowTickEvent();
@@ -1013,19 +1028,22 @@ void StateGameLoop()
 		PlayerID p = _current_player;
 		_current_player = OWNER_NONE;
 
-		AnimateAnimatedTiles();
+		RunGameLoopPhase(GLP_ANIMATED_TILES, AnimateAnimatedTiles);
 		IncreaseDate();
-		RunTileLoop();
-		CallVehicleTicks();
-		CallLandscapeTick();
+		RunGameLoopPhase(GLP_TILE_LOOP, RunTileLoop);
+		RunGameLoopPhase(GLP_VEHICLES, CallVehicleTicks);
+		RunGameLoopPhase(GLP_LANDSCAPE, CallLandscapeTick);
 		ClearStorageChanges(true);
 
-		AI_RunGameLoop();
+		RunGameLoopPhase(GLP_AI, AI_RunGameLoop);
 
 		CallWindowTickEvent();
 		NewsLoop();
 		_current_player = p;
 	}
+
+	_game_loop_phase_time[GLP_STATE_LOOP] = (uint32)(GetTimeMicroseconds() - start);
+	StoreGameLoopProfile();
 }
 
 /** Create an autosave. The default name is "autosave#.sav". However with
@@ -1348,6 +1366,12 @@ bool AfterLoadGame()
 	TileIndex map_size = MapSize();
 	Player *p;
 
+	/* The slope cache is not saved; everything below may need it */
+	RebuildTileSlopeCache();
+
+	/* Size the hash of vehicle positions for the loaded map before vehicles are put in it */
+	ResetVehiclePosHash();
+
 	/* in version 2.1 of the savegame, town owner was unified. */
 	if (CheckSavegameVersionOldStyle(2, 1)) ConvertTownOwner();
 
@@ -2483,6 +2507,10 @@ bool AfterLoadGame()
 		}
 	}
 
+	/* The periodic station and industry handlers are scheduled from their saved counters */
+	RebuildStationRatingSchedule();
+	RebuildIndustryProductionSchedule();
+
 	return InitializeWindowsAndCaches();
 }
 
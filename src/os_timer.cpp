@@ -77,3 +77,28 @@ uint64 _rdtsc()
 # endif
 uint64 _rdtsc() {return 0;}
 #endif
+
+#if defined(WIN32) || defined(WINCE)
+#include <windows.h>
+uint64 GetTimeMicroseconds()
+{
+	static LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+
+	if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	/* Split the division so the multiplication can not overflow */
+	return (uint64)(counter.QuadPart / frequency.QuadPart) * 1000000 +
+		(uint64)(counter.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart;
+}
+#else
+#include <sys/time.h>
+uint64 GetTimeMicroseconds()
+{
+	struct timeval tim;
+
+	gettimeofday(&tim, NULL);
+	return (uint64)tim.tv_sec * 1000000 + tim.tv_usec;
+}
+#endif
@@ -0,0 +1,118 @@
+/* $Id$ */
+
+/** @file profiler.cpp Measuring the run time of the parts of the game loop. */
+
+#include "stdafx.h"
+#include "openttd.h"
+#include "profiler.h"
+#include "console.h"
+#include "date_func.h"
+#include "core/math_func.hpp"
+
+#include "safeguards.h"
+
+uint32 _game_loop_phase_time[GLP_END];
+TickScheduleStats _tick_schedule_stats;
+
+/** The measurements of the last PROFILE_HISTORY_SIZE ticks, as ring buffer. */
+static uint32 _profile_history[PROFILE_HISTORY_SIZE][GLP_END];
+/** Position in _profile_history the next tick is stored at. */
+static uint _profile_pos;
+/** Number of valid ticks in _profile_history. */
+static uint _profile_count;
+
+/** Names of the phases, as shown to the user. */
+static const char * const _game_loop_phase_names[] = {
+	"animated_tiles",
+	"tile_loop",
+	"vehicles",
+	"landscape",
+	"ai",
+	"towns",
+	"trees",
+	"stations",
+	"industries",
+	"players",
+	"trains",
+	"state_loop",
+};
+assert_compile(lengthof(_game_loop_phase_names) == GLP_END);
+
+/**
+ * Get the name of a phase, as shown to the user.
+ * @param phase the phase to get the name of
+ * @return the name
+ */
+const char *GetGameLoopPhaseName(GameLoopPhase phase)
+{
+	return _game_loop_phase_names[phase];
+}
+
+/** Add the measurements of the tick that just finished to the history. */
+void StoreGameLoopProfile()
+{
+	memcpy(_profile_history[_profile_pos], _game_loop_phase_time, sizeof(_game_loop_phase_time));
+	_profile_pos = (_profile_pos + 1) % PROFILE_HISTORY_SIZE;
+	if (_profile_count < PROFILE_HISTORY_SIZE) _profile_count++;
+}
+
+/** Forget all measurements made until now. */
+void ResetGameLoopProfile()
+{
+	_profile_pos = 0;
+	_profile_count = 0;
+	memset(&_tick_schedule_stats, 0, sizeof(_tick_schedule_stats));
+}
+
+/**
+ * Summarize the measurements of the most recent ticks.
+ * @param ticks   the number of ticks to summarize; limited to the number of recorded ticks
+ * @param profile the summary to fill
+ */
+void GetGameLoopProfile(uint ticks, GameLoopProfile *profile)
+{
+	memset(profile, 0, sizeof(*profile));
+	profile->ticks = min(ticks, _profile_count);
+
+	uint pos = _profile_pos;
+	for (uint i = 0; i < profile->ticks; i++) {
+		pos = (pos + PROFILE_HISTORY_SIZE - 1) % PROFILE_HISTORY_SIZE;
+		for (uint p = 0; p < GLP_END; p++) {
+			uint32 time = _profile_history[pos][p];
+			profile->total[p] += time;
+			profile->worst[p] = max(profile->worst[p], time);
+		}
+	}
+}
+
+/**
+ * Print how many days are simulated per second every now and then.
+ * Has to be called every tick the game is fast forwarded.
+ */
+void ReportFastForwardProgress()
+{
+	/* Microseconds between two reports */
+	static const uint64 REPORT_INTERVAL = 10 * 1000000;
+
+	static uint64 last_time = 0;
+	static Date last_date = 0;
+
+	uint64 now = GetTimeMicroseconds();
+
+	/* Start measuring anew when this is the first call in a while */
+	if (last_time == 0 || now - last_time > 2 * REPORT_INTERVAL || _date < last_date) {
+		last_time = now;
+		last_date = _date;
+		return;
+	}
+
+	if (now - last_time < REPORT_INTERVAL) return;
+
+	YearMonthDay ymd;
+	ConvertDateToYMD(_date, &ymd);
+	IConsolePrintF(_icolour_def, "Fast forward: %d-%02d-%02d, %.1f days per second",
+		ymd.year, ymd.month + 1, ymd.day, (_date - last_date) * 1000000.0 / (now - last_time));
+
+	last_time = now;
+	last_date = _date;
+}
@@ -0,0 +1,72 @@
+/* $Id$ */
+
+/** @file profiler.h Measuring the run time of the parts of the game loop. */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "debug.h"
+
+/**
+ * Parts of StateGameLoop() whose run time is measured every tick.
+ * The landscape tick handlers are measured separately as well, so
+ * their time is also part of GLP_LANDSCAPE.
+ */
+enum GameLoopPhase {
+	GLP_ANIMATED_TILES, ///< AnimateAnimatedTiles()
+	GLP_TILE_LOOP,      ///< RunTileLoop()
+	GLP_VEHICLES,       ///< CallVehicleTicks()
+	GLP_LANDSCAPE,      ///< CallLandscapeTick()
+	GLP_AI,             ///< AI_RunGameLoop()
+	GLP_TOWNS,          ///< OnTick_Town(), part of CallLandscapeTick()
+	GLP_TREES,          ///< OnTick_Trees(), part of CallLandscapeTick()
+	GLP_STATIONS,       ///< OnTick_Station(), part of CallLandscapeTick()
+	GLP_INDUSTRIES,     ///< OnTick_Industry(), part of CallLandscapeTick()
+	GLP_PLAYERS,        ///< OnTick_Players(), part of CallLandscapeTick()
+	GLP_TRAINS,         ///< OnTick_Train(), part of CallLandscapeTick()
+	GLP_STATE_LOOP,     ///< The whole of StateGameLoop()
+	GLP_END
+};
+
+/** Number of ticks the profiler keeps the measurements of. */
+static const uint PROFILE_HISTORY_SIZE = 4096;
+
+/** Summary of the measurements of a number of ticks. */
+struct GameLoopProfile {
+	uint ticks;             ///< Number of ticks that are summarized.
+	uint64 total[GLP_END];  ///< Total time per phase in microseconds.
+	uint32 worst[GLP_END];  ///< Longest time of a single tick per phase in microseconds.
+};
+
+/** How well the ticks kept to the schedule of a video driver that keeps track of it. */
+struct TickScheduleStats {
+	uint32 ticks;       ///< Number of ticks that were scheduled.
+	uint32 overruns;    ///< Number of ticks that started a whole tick interval or more too late.
+	uint32 dropped;     ///< Number of ticks that were skipped because the game fell too far behind.
+	uint32 worst_delay; ///< Longest delay in milliseconds a tick started with.
+};
+
+extern TickScheduleStats _tick_schedule_stats;
+
+/** Time in microseconds each phase took during the last StateGameLoop(). */
+extern uint32 _game_loop_phase_time[GLP_END];
+
+/**
+ * Run a single phase of the game loop and record how long it took.
+ * @param phase the phase to account the time to
+ * @param proc  the function implementing the phase
+ */
+static inline void RunGameLoopPhase(GameLoopPhase phase, void (*proc)())
+{
+	uint64 start = GetTimeMicroseconds();
+	proc();
+	_game_loop_phase_time[phase] = (uint32)(GetTimeMicroseconds() - start);
+}
+
+const char *GetGameLoopPhaseName(GameLoopPhase phase);
+void StoreGameLoopProfile();
+void ResetGameLoopProfile();
+void GetGameLoopProfile(uint ticks, GameLoopProfile *profile);
+void ReportFastForwardProgress();
+
+#endif /* PROFILER_H */
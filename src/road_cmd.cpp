@@ -157,6 +157,8 @@ static CommandCost RemoveRoad(TileIndex tile, uint32 flags, RoadBits pieces, Roa
 			if (flags & DC_EXEC) {
 				SetRoadTypes(other_end, GetRoadTypes(other_end) & ~RoadTypeToRoadTypes(rt));
 				SetRoadTypes(tile, GetRoadTypes(tile) & ~RoadTypeToRoadTypes(rt));
+				YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
+				YapfNotifyTrackLayoutChange(other_end, INVALID_TRACK);
 
 				/* Mark tiles diry that have been repaved */
 				MarkTileDirtyByTile(tile);
@@ -173,6 +175,7 @@ static CommandCost RemoveRoad(TileIndex tile, uint32 flags, RoadBits pieces, Roa
 			if (flags & DC_EXEC) {
 				SetRoadTypes(tile, GetRoadTypes(tile) & ~RoadTypeToRoadTypes(rt));
 				MarkTileDirtyByTile(tile);
+				YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 			}
 		}
 		return cost;
@@ -198,6 +201,7 @@ static CommandCost RemoveRoad(TileIndex tile, uint32 flags, RoadBits pieces, Roa
 			if (town_check) ChangeTownRating(t, -road_remove_cost[(byte)edge_road], RATING_ROAD_MINIMUM);
 			if (flags & DC_EXEC) {
 				present ^= c;
+				YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 				if (HasRoadWorks(tile)) {
 					/* flooding tile with road works, don't forget to remove the effect vehicle too */
 					assert(_current_player == OWNER_WATER);
@@ -463,6 +467,7 @@ CommandCost CmdBuildRoad(TileIndex tile, uint32 flags, uint32 p1, uint32 p2)
 							if (flags & DC_EXEC && rt != ROADTYPE_TRAM && (existing == ROAD_X || existing == ROAD_Y)) {
 								SetDisallowedRoadDirections(tile, GetDisallowedRoadDirections(tile) ^ toggle_drd);
 								MarkTileDirtyByTile(tile);
+								YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 							}
 							return CommandCost();
 						}
@@ -605,6 +610,7 @@ do_clear:;
 
 				SetRoadTypes(other_end, GetRoadTypes(other_end) | RoadTypeToRoadTypes(rt));
 				SetRoadTypes(tile, GetRoadTypes(tile) | RoadTypeToRoadTypes(rt));
+				YapfNotifyTrackLayoutChange(other_end, INVALID_TRACK);
 
 				/* Mark tiles diry that have been repaved */
 				MarkTileDirtyByTile(other_end);
@@ -633,6 +639,7 @@ do_clear:;
 		}
 
 		MarkTileDirtyByTile(tile);
+		YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 	}
 	return cost;
 }
@@ -833,6 +840,7 @@ CommandCost CmdBuildRoadDepot(TileIndex tile, uint32 flags, uint32 p1, uint32 p2
 
 		MakeRoadDepot(tile, _current_player, dir, rt);
 		MarkTileDirtyByTile(tile);
+		YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 	}
 	return cost.AddCost(_price.build_road_depot);
 }
@@ -847,6 +855,7 @@ static CommandCost RemoveRoadDepot(TileIndex tile, uint32 flags)
 	if (flags & DC_EXEC) {
 		DoClearSquare(tile);
 		delete GetDepotByTile(tile);
+		YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 	}
 
 	return CommandCost(EXPENSES_CONSTRUCTION, _price.remove_road_depot);
@@ -1280,6 +1289,7 @@ static void TileLoop_Road(TileIndex tile)
 					IsNormalRoad(tile) && CountBits(GetAllRoadBits(tile)) > 1 ) {
 				if (GetTileSlope(tile, NULL) == SLOPE_FLAT && EnsureNoVehicleOnGround(tile) && Chance16(1, 40)) {
 					StartRoadWorks(tile);
+					YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 
 					SndPlayTileFx(SND_21_JACKHAMMER, tile);
 					CreateEffectVehicleAbove(
@@ -1316,6 +1326,7 @@ static void TileLoop_Road(TileIndex tile)
 		}
 	} else if (IncreaseRoadWorksCounter(tile)) {
 		TerminateRoadWorks(tile);
+		YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 
 		if (_patches.mod_road_rebuild) {
 			/* Generate a nicer town surface */
@@ -1461,6 +1472,7 @@ static void ChangeTileOwner_Road(TileIndex tile, PlayerID old_player, PlayerID n
 				DoCommand(tile, 0, 0, DC_EXEC | DC_BANKRUPT, CMD_LANDSCAPE_CLEAR);
 			} else {
 				SetTileOwner(tile, new_player);
+				YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 			}
 		}
 		return;
@@ -62,7 +62,7 @@ void RoadVehUpdateCache(Vehicle *v);
  */
 struct RoadVehicle : public Vehicle {
 	/** Initializes the Vehicle to a road vehicle */
-	RoadVehicle() { this->type = VEH_ROAD; }
+	RoadVehicle() { this->type = VEH_ROAD; UpdateVehicleTickList(this); }
 
 	/** We want to 'destruct' the right class. */
 	virtual ~RoadVehicle() { this->PreDestructor(); }
@@ -313,6 +313,7 @@ CommandCost CmdStartStopRoadVeh(TileIndex tile, uint32 flags, uint32 p1, uint32
 			DeleteVehicleNews(p1, STR_9016_ROAD_VEHICLE_IS_WAITING);
 		}
 
+		WakeVehicle(v);
 		v->vehstatus ^= VS_STOPPED;
 		v->cur_speed = 0;
 		InvalidateWindowWidget(WC_VEHICLE_VIEW, v->index, VVW_WIDGET_START_STOP_VEH);
@@ -1932,7 +1933,8 @@ static void AgeRoadVehCargo(Vehicle *v)
 
 void RoadVehicle::Tick()
 {
-	AgeRoadVehCargo(this);
+	/* Articulated parts are not ticked on their own */
+	for (Vehicle *u = this; u != NULL; u = u->Next()) AgeRoadVehCargo(u);
 
 	if (IsRoadVehFront(this)) {
 		if (!(this->vehstatus & VS_STOPPED)) this->running_ticks++;
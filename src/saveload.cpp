@@ -36,7 +36,7 @@
 
 #include "table/strings.h"
 
-extern const uint16 SAVEGAME_VERSION = 92;
+extern const uint16 SAVEGAME_VERSION = 94;
 uint16 _sl_version;       ///< the major savegame version identifier
 byte   _sl_minor_version; ///< the minor savegame version, DO NOT USE!
 char _savegame_format[8]; ///< how to compress savegames
@@ -1128,8 +1128,9 @@ struct ThreadedSave {
 	CursorID cursor;
 };
 
-/* A maximum size of of 128K * 500 = 64.000KB savegames */
-STATIC_OLD_POOL(Savegame, byte, 17, 500, NULL, NULL)
+/* A maximum size of of 128K * 8000 = 1.000.000KB savegames; the map
+ * arrays alone of a 8192x8192 map take 640.000KB */
+STATIC_OLD_POOL(Savegame, byte, 17, 8000, NULL, NULL)
 static ThreadedSave _ts;
 
 static bool InitMem()
@@ -1154,7 +1155,7 @@ static void WriteMem(uint size)
 {
 	_ts.count += size;
 	/* Allocate new block and new buffer-pointer */
-	_Savegame_pool.AddBlockIfNeeded(_ts.count);
+	if (!_Savegame_pool.AddBlockIfNeeded(_ts.count)) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "savegame too big");
 	_sl.buf = GetSavegame(_ts.count);
 }
 
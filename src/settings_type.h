@@ -232,6 +232,9 @@ struct Patches {
 	bool give_money;             ///< allow giving other players money
 
 	bool enable_signal_gui;      ///< Show the signal GUI when the signal button is pressed
+
+	bool parallel_tile_loop;     ///< Run the tile loop in independent regions (changes the game state, so it is synced)
+	uint8 tile_loop_threads;     ///< Number of threads handling the regions of the parallel tile loop
 };
 
 extern Patches _patches;
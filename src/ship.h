@@ -12,6 +12,7 @@
 void CcBuildShip(bool success, TileIndex tile, uint32 p1, uint32 p2);
 void RecalcShipStuff(Vehicle *v);
 void GetShipSpriteSize(EngineID engine, uint &width, uint &height);
+void QueueShipPathSearches();
 
 /**
  * This class 'wraps' Vehicle; you do not actually instantiate this class.
@@ -23,7 +24,7 @@ void GetShipSpriteSize(EngineID engine, uint &width, uint &height);
  */
 struct Ship: public Vehicle {
 	/** Initializes the Vehicle to a ship */
-	Ship() { this->type = VEH_SHIP; }
+	Ship() { this->type = VEH_SHIP; UpdateVehicleTickList(this); }
 
 	/** We want to 'destruct' the right class. */
 	virtual ~Ship() { this->PreDestructor(); }
@@ -349,6 +349,26 @@ static bool ShipAccelerate(Vehicle *v)
 	return (t < v->progress);
 }
 
+/**
+ * Check whether ShipAccelerate() is going to let a ship move in this
+ * tick, without changing the ship.
+ * @param v the ship
+ * @return true if the ship moves
+ */
+static bool ShipWillMove(const Vehicle *v)
+{
+	uint spd = min(v->cur_speed + 1, GetVehicleProperty(v, 0x0B, v->max_speed));
+
+	/* Decrease somewhat when turning */
+	if (!(v->direction & 1)) spd = spd * 3 / 4;
+
+	if (spd == 0) return false;
+	if ((byte)++spd == 0) return true;
+
+	byte t = v->progress;
+	return t < (byte)(t - (byte)spd);
+}
+
 static CommandCost EstimateShipCost(EngineID engine_type)
 {
 	return CommandCost(EXPENSES_NEW_VEHICLES, GetEngineProperty(engine_type, 0x0A, ShipVehInfo(engine_type)->base_cost) * (_price.ship_base >> 3) >> 5);
@@ -723,6 +743,36 @@ reverse_direction:
 	goto getout;
 }
 
+/**
+ * Queue the path searches of the ships that are going to enter a new tile
+ * in this tick and run them on the worker threads of the parallel tile
+ * loop, before the vehicles tick. A ship that does something else than
+ * expected, for example because it got a new order, searches its way
+ * itself when it gets to the tile.
+ */
+void QueueShipPathSearches()
+{
+	if (_patches.pathfinder_for_ships != VPF_YAPF || GetWorkerJobCount() == 1) return;
+
+	const Vehicle *v;
+	FOR_ALL_VEHICLES(v) {
+		if (v->type != VEH_SHIP || (v->vehstatus & VS_STOPPED) || v->IsInDepot()) continue;
+		/* See ShipController() */
+		if ((v->breakdown_ctr != 0 && v->breakdown_ctr <= 2) || v->current_order.type == OT_LOADING) continue;
+		if (!ShipWillMove(v)) continue;
+
+		GetNewVehiclePosResult gp = GetNewVehiclePos(v);
+		if (gp.old_tile == gp.new_tile || TileX(gp.new_tile) >= MapMaxX() || TileY(gp.new_tile) >= MapMaxY()) continue;
+
+		DiagDirection diagdir = DirToDiagDir(ShipGetNewDirectionFromTiles(gp.new_tile, gp.old_tile));
+		if (GetAvailShipTracks(gp.new_tile, diagdir) == TRACK_BIT_NONE) continue;
+
+		YapfQueueShipSearch(v, gp.new_tile, diagdir);
+	}
+
+	YapfRunShipSearches();
+}
+
 static void AgeShipCargo(Vehicle *v)
 {
 	if (_age_cargo_skip_counter != 0) return;
@@ -907,6 +957,7 @@ CommandCost CmdStartStopShip(TileIndex tile, uint32 flags, uint32 p1, uint32 p2)
 			DeleteVehicleNews(p1, STR_981C_SHIP_IS_WAITING_IN_DEPOT);
 		}
 
+		WakeVehicle(v);
 		v->vehstatus ^= VS_STOPPED;
 		v->cur_speed = 0;
 		InvalidateWindowWidget(WC_VEHICLE_VIEW, v->index, VVW_WIDGET_START_STOP_VEH);
@@ -57,7 +57,7 @@ static inline bool IsValidSignID(uint index)
 	return index < GetSignPoolSize() && GetSign(index)->IsValid();
 }
 
-#define FOR_ALL_SIGNS_FROM(ss, start) for (ss = GetSign(start); ss != NULL; ss = (ss->index + 1U < GetSignPoolSize()) ? GetSign(ss->index + 1U) : NULL) if (ss->IsValid())
+#define FOR_ALL_SIGNS_FROM(ss, start) for (ss = _Sign_pool.GetNextLive(start); ss != NULL; ss = _Sign_pool.GetNextLive(ss->index + 1U)) if (ss->IsValid())
 #define FOR_ALL_SIGNS(ss) FOR_ALL_SIGNS_FROM(ss, 0)
 
 extern bool _sign_sort_dirty;
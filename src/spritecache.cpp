@@ -15,6 +15,7 @@
 #include "spriteloader/png.hpp"
 #endif /* WITH_PNG */
 #include "blitter/factory.hpp"
+#include "meminfo.h"
 
 #include "table/sprites.h"
 
@@ -486,6 +487,29 @@ const void *GetRawSprite(SpriteID sprite, bool real_sprite)
 }
 
 
+/**
+ * Get the memory the sprite cache takes.
+ * @param usage the place to store the memory usage in
+ */
+void GetSpriteCacheMemoryUsage(MemoryUsage *usage)
+{
+	usage->name = "sprite_cache";
+	usage->allocated = (uint64)_spritecache_items * sizeof(*_spritecache);
+	usage->used = usage->allocated;
+	usage->items = 0;
+	usage->capacity = _spritecache_items;
+	usage->peak = 0;
+
+	if (_spritecache_ptr == NULL) return;
+
+	usage->allocated += _sprite_cache_size * 1024 * 1024;
+	for (MemBlock *s = _spritecache_ptr; s->size != 0; s = NextBlock(s)) {
+		if (s->size & S_FREE_MASK) continue;
+		usage->used += s->size;
+		usage->items++;
+	}
+}
+
 void GfxInitSpriteMem()
 {
 	/* initialize sprite cache heap */
@@ -72,6 +72,8 @@ Station::~Station()
 
 	if (CleaningPool()) return;
 
+	StopStationRatingUpdates(this->index);
+
 	while (!loading_vehicles.empty()) {
 		loading_vehicles.front()->LeaveStation();
 	}
@@ -129,11 +131,13 @@ RoadStop *Station::GetPrimaryRoadStop(const Vehicle *v) const
  * it initializes also 'xy' and 'random_bits' members */
 void Station::AddFacility(byte new_facility_bit, TileIndex facil_xy)
 {
-	if (facilities == 0) {
+	bool first = (facilities == 0);
+	if (first) {
 		xy = facil_xy;
 		random_bits = Random();
 	}
 	facilities |= new_facility_bit;
+	if (first) StartStationRatingUpdates(this);
 	owner = _current_player;
 	build_date = _date;
 }
@@ -274,19 +274,22 @@ static inline bool IsValidStationID(StationID index)
 	return index < GetStationPoolSize() && GetStation(index)->IsValid();
 }
 
-#define FOR_ALL_STATIONS_FROM(st, start) for (st = GetStation(start); st != NULL; st = (st->index + 1U < GetStationPoolSize()) ? GetStation(st->index + 1U) : NULL) if (st->IsValid())
+#define FOR_ALL_STATIONS_FROM(st, start) for (st = _Station_pool.GetNextLive(start); st != NULL; st = _Station_pool.GetNextLive(st->index + 1U)) if (st->IsValid())
 #define FOR_ALL_STATIONS(st) FOR_ALL_STATIONS_FROM(st, 0)
 
 
 /* Stuff for ROADSTOPS */
 
-#define FOR_ALL_ROADSTOPS_FROM(rs, start) for (rs = GetRoadStop(start); rs != NULL; rs = (rs->index + 1U < GetRoadStopPoolSize()) ? GetRoadStop(rs->index + 1U) : NULL) if (rs->IsValid())
+#define FOR_ALL_ROADSTOPS_FROM(rs, start) for (rs = _RoadStop_pool.GetNextLive(start); rs != NULL; rs = _RoadStop_pool.GetNextLive(rs->index + 1U)) if (rs->IsValid())
 #define FOR_ALL_ROADSTOPS(rs) FOR_ALL_ROADSTOPS_FROM(rs, 0)
 
 /* End of stuff for ROADSTOPS */
 
 
 void AfterLoadStations();
+void RebuildStationRatingSchedule();
+void StartStationRatingUpdates(const Station *st);
+void StopStationRatingUpdates(StationID index);
 void GetProductionAroundTiles(AcceptedCargo produced, TileIndex tile, int w, int h, int rad);
 void GetAcceptanceAroundTiles(AcceptedCargo accepts, TileIndex tile, int w, int h, int rad);
 
@@ -42,6 +42,7 @@
 #include "vehicle_func.h"
 #include "string_func.h"
 #include "signal_func.h"
+#include "timer_wheel.h"
 
 #include "table/sprites.h"
 #include "table/strings.h"
@@ -682,6 +683,7 @@ static void UpdateStationSignCoord(Station *st)
 static void DeleteStationIfEmpty(Station *st)
 {
 	if (st->facilities == 0) {
+		StopStationRatingUpdates(st->index);
 		st->delete_ctr = 0;
 		RebuildStationLists();
 		InvalidateWindow(WC_STATION_LIST, st->owner);
@@ -1065,10 +1067,10 @@ CommandCost CmdBuildRailroadStation(TileIndex tile_org, uint32 flags, uint32 p1,
 					if (callback != CALLBACK_FAILED && callback < 8) SetStationGfx(tile, (callback & ~1) + axis);
 				}
 
+				YapfNotifyTrackLayoutChange(tile, track);
 				tile += tile_delta;
 			} while (--w);
 			AddTrackToSignalBuffer(tile_org, track, _current_player);
-			YapfNotifyTrackLayoutChange(tile_org, track);
 			tile_org += tile_delta ^ TileDiffXY(1, 1); // perpendicular to tile_delta
 		} while (--numtracks);
 
@@ -1438,6 +1440,7 @@ CommandCost CmdBuildRoadStop(TileIndex tile, uint32 flags, uint32 p1, uint32 p2)
 		} else {
 			MakeRoadStop(tile, st->owner, st->index, rs_type, rts, (DiagDirection)p1);
 		}
+		YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 
 		UpdateStationVirtCoordDirty(st);
 		UpdateStationAcceptance(st, false);
@@ -1509,6 +1512,7 @@ static CommandCost RemoveRoadStop(Station *st, uint32 flags, TileIndex tile)
 		InvalidateWindowWidget(WC_STATION_VIEW, st->index, SVW_ROADVEHS);
 		delete cur_stop;
 		DoClearSquare(tile);
+		YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 		st->rect.AfterRemoveTile(st, tile);
 
 		UpdateStationVirtCoordDirty(st);
@@ -1844,10 +1848,12 @@ CommandCost CmdBuildBuoy(TileIndex tile, uint32 flags, uint32 p1, uint32 p2)
 		 * braindead.. */
 		st->had_vehicle_of_type |= HVOT_BUOY;
 		st->owner = OWNER_NONE;
+		StartStationRatingUpdates(st);
 
 		st->build_date = _date;
 
 		MakeBuoy(tile, st->index, GetWaterClass(tile));
+		YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 
 		UpdateStationVirtCoordDirty(st);
 		UpdateStationAcceptance(st, false);
@@ -1906,6 +1912,7 @@ static CommandCost RemoveBuoy(Station *st, uint32 flags)
 		 * remove it and flood the land (if the canal edge is at level 0) */
 		MakeWaterKeepingClass(tile, GetTileOwner(tile));
 		MarkTileDirtyByTile(tile);
+		YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 
 		UpdateStationVirtCoordDirty(st);
 		DeleteStationIfEmpty(st);
@@ -2010,6 +2017,8 @@ CommandCost CmdBuildDock(TileIndex tile, uint32 flags, uint32 p1, uint32 p2)
 		st->rect.BeforeAddRect(tile, _dock_w_chk[direction], _dock_h_chk[direction], StationRect::ADD_TRY);
 
 		MakeDock(tile, st->owner, st->index, direction, wc);
+		YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
+		YapfNotifyTrackLayoutChange(tile + TileOffsByDiagDir(direction), INVALID_TRACK);
 
 		UpdateStationVirtCoordDirty(st);
 		UpdateStationAcceptance(st, false);
@@ -2033,6 +2042,8 @@ static CommandCost RemoveDock(Station *st, uint32 flags)
 	if (flags & DC_EXEC) {
 		DoClearSquare(tile1);
 		MakeWaterKeepingClass(tile2, st->owner);
+		YapfNotifyTrackLayoutChange(tile1, INVALID_TRACK);
+		YapfNotifyTrackLayoutChange(tile2, INVALID_TRACK);
 
 		st->rect.AfterRemoveTile(st, tile1);
 		st->rect.AfterRemoveTile(st, tile2);
@@ -2561,16 +2572,60 @@ static void UpdateStationRating(Station *st)
 	}
 }
 
-/* called for every station each tick */
-static void StationHandleSmallTick(Station *st)
+/** Number of ticks between two rating updates of a station */
+static const uint STATION_RATING_TICKS = 185;
+
+static uint StationRatingTimerProc(uint index)
 {
-	if (st->facilities == 0) return;
+	UpdateStationRating(GetStation(index));
+	return STATION_RATING_TICKS;
+}
 
-	byte b = st->delete_ctr + 1;
-	if (b >= 185) b = 0;
-	st->delete_ctr = b;
+/**
+ * Rating updates of all stations with facilities. For those stations
+ * delete_ctr counts the ticks since the last rating update; it is only
+ * brought up to date when saving, the wheel keeps track of it otherwise.
+ */
+static TimerWheel _station_rating_wheel(&StationRatingTimerProc);
+
+/**
+ * Schedule the rating updates of a station that got its first facility.
+ * @param st the station; delete_ctr holds the ticks since its last update
+ */
+void StartStationRatingUpdates(const Station *st)
+{
+	uint delay = (st->delete_ctr < STATION_RATING_TICKS) ? STATION_RATING_TICKS - st->delete_ctr : 1;
+	_station_rating_wheel.Schedule(st->index, delay);
+}
 
-	if (b == 0) UpdateStationRating(st);
+/**
+ * Stop the rating updates of a station that lost its last facility.
+ * @param index the station
+ */
+void StopStationRatingUpdates(StationID index)
+{
+	_station_rating_wheel.Cancel(index);
+}
+
+/** Bring delete_ctr of all stations with facilities up to date. */
+static void UpdateStationRatingCounters()
+{
+	Station *st;
+	FOR_ALL_STATIONS(st) {
+		if (!_station_rating_wheel.IsScheduled(st->index)) continue;
+		st->delete_ctr = STATION_RATING_TICKS - _station_rating_wheel.GetRemaining(st->index);
+	}
+}
+
+/** Schedule the rating updates of all stations after loading a game. */
+void RebuildStationRatingSchedule()
+{
+	_station_rating_wheel.Clear();
+
+	const Station *st;
+	FOR_ALL_STATIONS(st) {
+		if (st->facilities != 0) StartStationRatingUpdates(st);
+	}
 }
 
 void OnTick_Station()
@@ -2582,8 +2637,7 @@ void OnTick_Station()
 
 	if (IsValidStationID(i)) StationHandleBigTick(GetStation(i));
 
-	Station *st;
-	FOR_ALL_STATIONS(st) StationHandleSmallTick(st);
+	_station_rating_wheel.Tick();
 }
 
 void StationMonthlyLoop()
@@ -2820,6 +2874,7 @@ void BuildOilRig(TileIndex tile)
 	GenerateStationName(st, tile, STATIONNAMING_OILRIG);
 
 	MakeOilrig(tile, st->index);
+	YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 
 	st->owner = OWNER_NONE;
 	st->airport_flags = 0;
@@ -2837,6 +2892,7 @@ void BuildOilRig(TileIndex tile)
 	st->last_vehicle_type = VEH_INVALID;
 	st->facilities = FACIL_AIRPORT | FACIL_DOCK;
 	st->build_date = _date;
+	StartStationRatingUpdates(st);
 
 	for (CargoID j = 0; j < NUM_CARGO; j++) {
 		st->goods[j].acceptance_pickup = 0;
@@ -2855,6 +2911,7 @@ void DeleteOilRig(TileIndex tile)
 	Station* st = GetStationByTile(tile);
 
 	MakeWater(tile);
+	YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 
 	st->dock_tile = 0;
 	st->airport_tile = 0;
@@ -2958,6 +3015,7 @@ void InitializeStations()
 
 	_station_tick_ctr = 0;
 
+	_station_rating_wheel.Clear();
 }
 
 
@@ -3180,6 +3238,8 @@ void SaveLoad_STNS(Station *st)
 
 static void Save_STNS()
 {
+	UpdateStationRatingCounters();
+
 	Station *st;
 	/* Write the stations */
 	FOR_ALL_STATIONS(st) {
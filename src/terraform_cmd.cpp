@@ -12,6 +12,13 @@
 #include "variables.h"
 #include "functions.h"
 #include "economy_func.h"
+#include "tile_cmd.h"
+#include "direction_type.h"
+#include "track_type.h"
+#include "track_func.h"
+#include "road_type.h"
+#include "vehicle_type.h"
+#include "yapf/yapf.h"
 
 #include "table/strings.h"
 
@@ -336,6 +343,13 @@ CommandCost CmdTerraformLand(TileIndex tile, uint32 flags, uint32 p1, uint32 p2)
 			TileIndex *ti = ts.tile_table;
 			for (count = ts.tile_table_count; count != 0; count--, ti++) {
 				MarkTileDirtyByTile(*ti);
+				/* The slope of track or road changed, so did the cost of going over it;
+				 * coast tiles can become usable for ships or stop being so */
+				if (TrackStatusToTrackBits(GetTileTrackStatus(*ti, TRANSPORT_RAIL, 0)) != TRACK_BIT_NONE ||
+						TrackStatusToTrackBits(GetTileTrackStatus(*ti, TRANSPORT_ROAD, ROADTYPES_ALL)) != TRACK_BIT_NONE ||
+						IsTileType(*ti, MP_WATER)) {
+					YapfNotifyTrackLayoutChange(*ti, INVALID_TRACK);
+				}
 			}
 		}
 	}
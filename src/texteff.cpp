@@ -426,12 +426,86 @@ void DrawTextEffects(DrawPixelInfo *dpi)
 	}
 }
 
-/** The table/list with animated tiles. */
+/**
+ * The table/list with animated tiles, in the order they have been added.
+ * Removed tiles leave a hole (INVALID_TILE) that is squeezed out after the
+ * next animation pass, so removing tiles never shifts the list while it
+ * is being walked.
+ */
 TileIndex *_animated_tile_list = NULL;
-/** The number of animated tiles in the current state. */
+/** The number of used slots (animated tiles and holes) in the list. */
 uint _animated_tile_count = 0;
 /** The number of slots for animated tiles allocated currently. */
 static uint _animated_tile_allocated = 0;
+/** The number of holes in the list. */
+static uint _animated_tile_holes = 0;
+
+/**
+ * Hash from tile to its slot in _animated_tile_list, using open addressing
+ * with linear probing. Empty buckets contain ANIMATED_TILE_NO_SLOT.
+ */
+static uint32 *_animated_tile_hash = NULL;
+/** Number of bits of the hash; it has 1 << bits buckets. */
+static uint _animated_tile_hash_bits = 0;
+
+static const uint32 ANIMATED_TILE_NO_SLOT = 0xFFFFFFFF;
+
+static inline uint AnimatedTileHash(TileIndex tile)
+{
+	return (tile * 0x9E3779B1U) >> (32 - _animated_tile_hash_bits);
+}
+
+/**
+ * Find the bucket of the hash for the given tile.
+ * @param tile the tile to look for
+ * @return the bucket holding the tile, or the empty bucket where it would go
+ */
+static uint FindAnimatedTileBucket(TileIndex tile)
+{
+	uint mask = (1 << _animated_tile_hash_bits) - 1;
+	uint bucket = AnimatedTileHash(tile);
+
+	while (_animated_tile_hash[bucket] != ANIMATED_TILE_NO_SLOT && _animated_tile_list[_animated_tile_hash[bucket]] != tile) {
+		bucket = (bucket + 1) & mask;
+	}
+	return bucket;
+}
+
+/**
+ * (Re)build the hash from the list. The hash is kept at least twice as
+ * large as the list, so it never gets full.
+ */
+void RebuildAnimatedTileHash()
+{
+	uint bits = 9;
+	while ((1U << bits) < _animated_tile_allocated * 2) bits++;
+
+	if (bits != _animated_tile_hash_bits) {
+		_animated_tile_hash_bits = bits;
+		_animated_tile_hash = ReallocT<uint32>(_animated_tile_hash, 1 << bits);
+	}
+	memset(_animated_tile_hash, 0xFF, sizeof(*_animated_tile_hash) << bits);
+
+	for (uint i = 0; i < _animated_tile_count; i++) {
+		if (_animated_tile_list[i] == INVALID_TILE) continue;
+		_animated_tile_hash[FindAnimatedTileBucket(_animated_tile_list[i])] = i;
+	}
+}
+
+/** Squeeze the holes out of the list, keeping the order of the tiles. */
+static void CompactAnimatedTiles()
+{
+	if (_animated_tile_holes == 0) return;
+
+	uint count = 0;
+	for (uint i = 0; i < _animated_tile_count; i++) {
+		if (_animated_tile_list[i] != INVALID_TILE) _animated_tile_list[count++] = _animated_tile_list[i];
+	}
+	_animated_tile_count = count;
+	_animated_tile_holes = 0;
+
+	RebuildAnimatedTileHash();
+}
 
 /**
  * Removes the given tile from the animated tile table.
@@ -439,18 +513,25 @@ static uint _animated_tile_allocated = 0;
  */
 void DeleteAnimatedTile(TileIndex tile)
 {
-	for (TileIndex *ti = _animated_tile_list; ti < _animated_tile_list + _animated_tile_count; ti++) {
-		if (tile == *ti) {
-			/* Remove the hole
-			 * The order of the remaining elements must stay the same, otherwise the animation loop
-			 * may miss a tile; that's why we must use memmove instead of just moving the last element.
-			 */
-			memmove(ti, ti + 1, (_animated_tile_list + _animated_tile_count - (ti + 1)) * sizeof(*ti));
-			_animated_tile_count--;
-			MarkTileDirtyByTile(tile);
-			return;
+	uint mask = (1 << _animated_tile_hash_bits) - 1;
+	uint bucket = FindAnimatedTileBucket(tile);
+	if (_animated_tile_hash[bucket] == ANIMATED_TILE_NO_SLOT) return;
+
+	_animated_tile_list[_animated_tile_hash[bucket]] = INVALID_TILE;
+	_animated_tile_holes++;
+
+	/* Remove the bucket; move later buckets of the same probe run back so
+	 * the tiles in them can still be found */
+	for (uint next = (bucket + 1) & mask; _animated_tile_hash[next] != ANIMATED_TILE_NO_SLOT; next = (next + 1) & mask) {
+		uint home = AnimatedTileHash(_animated_tile_list[_animated_tile_hash[next]]);
+		if (((next - home) & mask) >= ((next - bucket) & mask)) {
+			_animated_tile_hash[bucket] = _animated_tile_hash[next];
+			bucket = next;
 		}
 	}
+	_animated_tile_hash[bucket] = ANIMATED_TILE_NO_SLOT;
+
+	MarkTileDirtyByTile(tile);
 }
 
 /**
@@ -462,40 +543,34 @@ void AddAnimatedTile(TileIndex tile)
 {
 	MarkTileDirtyByTile(tile);
 
-	for (const TileIndex *ti = _animated_tile_list; ti < _animated_tile_list + _animated_tile_count; ti++) {
-		if (tile == *ti) return;
-	}
+	uint bucket = FindAnimatedTileBucket(tile);
+	if (_animated_tile_hash[bucket] != ANIMATED_TILE_NO_SLOT) return;
 
 	/* Table not large enough, so make it larger */
 	if (_animated_tile_count == _animated_tile_allocated) {
 		_animated_tile_allocated *= 2;
 		_animated_tile_list = ReallocT<TileIndex>(_animated_tile_list, _animated_tile_allocated);
+		RebuildAnimatedTileHash();
+		bucket = FindAnimatedTileBucket(tile);
 	}
 
+	_animated_tile_hash[bucket] = _animated_tile_count;
 	_animated_tile_list[_animated_tile_count] = tile;
 	_animated_tile_count++;
 }
 
 /**
  * Animate all tiles in the animated tile list, i.e.\ call AnimateTile on them.
+ * Tiles added during the pass are animated in the same pass, tiles removed
+ * during the pass are skipped when they have not been animated yet.
  */
 void AnimateAnimatedTiles()
 {
-	const TileIndex *ti = _animated_tile_list;
-	while (ti < _animated_tile_list + _animated_tile_count) {
-		const TileIndex curr = *ti;
-		AnimateTile(curr);
-		/* During the AnimateTile call, DeleteAnimatedTile could have been called,
-		 * deleting an element we've already processed and pushing the rest one
-		 * slot to the left. We can detect this by checking whether the index
-		 * in the current slot has changed - if it has, an element has been deleted,
-		 * and we should process the current slot again instead of going forward.
-		 * NOTE: this will still break if more than one animated tile is being
-		 *       deleted during the same AnimateTile call, but no code seems to
-		 *       be doing this anyway.
-		 */
-		if (*ti == curr) ++ti;
+	for (uint i = 0; i < _animated_tile_count; i++) {
+		if (_animated_tile_list[i] != INVALID_TILE) AnimateTile(_animated_tile_list[i]);
 	}
+
+	CompactAnimatedTiles();
 }
 
 /**
@@ -506,6 +581,8 @@ void InitializeAnimatedTiles()
 	_animated_tile_list = ReallocT<TileIndex>(_animated_tile_list, 256);
 	_animated_tile_count = 0;
 	_animated_tile_allocated = 256;
+	_animated_tile_holes = 0;
+	RebuildAnimatedTileHash();
 }
 
 /**
@@ -513,6 +590,8 @@ void InitializeAnimatedTiles()
  */
 static void Save_ANIT()
 {
+	CompactAnimatedTiles();
+
 	SlSetLength(_animated_tile_count * sizeof(*_animated_tile_list));
 	SlArray(_animated_tile_list, _animated_tile_count, SLE_UINT32);
 }
@@ -530,6 +609,7 @@ static void Load_ANIT()
 		for (_animated_tile_count = 0; _animated_tile_count < 256; _animated_tile_count++) {
 			if (_animated_tile_list[_animated_tile_count] == 0) break;
 		}
+		RebuildAnimatedTileHash();
 		return;
 	}
 
@@ -541,6 +621,7 @@ static void Load_ANIT()
 
 	_animated_tile_list = ReallocT<TileIndex>(_animated_tile_list, _animated_tile_allocated);
 	SlArray(_animated_tile_list, _animated_tile_count, SLE_UINT32);
+	RebuildAnimatedTileHash();
 }
 
 /**
@@ -311,3 +311,108 @@ void OTTDExitThread()
 }
 
 #endif
+
+
+/* Semaphores; where they are not available OTTDCreateSemaphore() returns
+ * NULL and the caller has to do without threads that keep running. */
+#if defined(__AMIGA__) || defined(PSP) || defined(NO_THREADS) || defined(__OS2__) || defined(MORPHOS)
+OTTDSemaphore *OTTDCreateSemaphore() { return NULL; }
+void OTTDDestroySemaphore(OTTDSemaphore *s) {}
+void OTTDSignalSemaphore(OTTDSemaphore *s) { NOT_REACHED(); }
+void OTTDWaitSemaphore(OTTDSemaphore *s) { NOT_REACHED(); }
+
+#elif defined(UNIX)
+
+#include <pthread.h>
+
+struct OTTDSemaphore {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	uint count;
+};
+
+OTTDSemaphore *OTTDCreateSemaphore()
+{
+	OTTDSemaphore *s = MallocT<OTTDSemaphore>(1);
+
+	if (s == NULL) return NULL;
+
+	s->count = 0;
+	if (pthread_mutex_init(&s->mutex, NULL) != 0) {
+		free(s);
+		return NULL;
+	}
+	if (pthread_cond_init(&s->cond, NULL) != 0) {
+		pthread_mutex_destroy(&s->mutex);
+		free(s);
+		return NULL;
+	}
+	return s;
+}
+
+void OTTDDestroySemaphore(OTTDSemaphore *s)
+{
+	if (s == NULL) return;
+
+	pthread_cond_destroy(&s->cond);
+	pthread_mutex_destroy(&s->mutex);
+	free(s);
+}
+
+void OTTDSignalSemaphore(OTTDSemaphore *s)
+{
+	pthread_mutex_lock(&s->mutex);
+	s->count++;
+	pthread_cond_signal(&s->cond);
+	pthread_mutex_unlock(&s->mutex);
+}
+
+void OTTDWaitSemaphore(OTTDSemaphore *s)
+{
+	pthread_mutex_lock(&s->mutex);
+	while (s->count == 0) pthread_cond_wait(&s->cond, &s->mutex);
+	s->count--;
+	pthread_mutex_unlock(&s->mutex);
+}
+
+#elif defined(WIN32)
+
+#include <windows.h>
+
+struct OTTDSemaphore {
+	HANDLE sem;
+};
+
+OTTDSemaphore *OTTDCreateSemaphore()
+{
+	OTTDSemaphore *s = MallocT<OTTDSemaphore>(1);
+
+	if (s == NULL) return NULL;
+
+	s->sem = CreateSemaphore(NULL, 0, 0x7FFFFFFF, NULL);
+	if (s->sem == NULL) {
+		free(s);
+		return NULL;
+	}
+	return s;
+}
+
+void OTTDDestroySemaphore(OTTDSemaphore *s)
+{
+	if (s == NULL) return;
+
+	CloseHandle(s->sem);
+	free(s);
+}
+
+void OTTDSignalSemaphore(OTTDSemaphore *s)
+{
+	ReleaseSemaphore(s->sem, 1, NULL);
+}
+
+void OTTDWaitSemaphore(OTTDSemaphore *s)
+{
+	WaitForSingleObject(s->sem, INFINITE);
+}
+
+#endif
@@ -13,4 +13,12 @@ OTTDThread *OTTDCreateThread(OTTDThreadFunc, void*);
 void       *OTTDJoinThread(OTTDThread*);
 void        OTTDExitThread();
 
+/** A counting semaphore to hand work to threads that keep running. */
+struct OTTDSemaphore;
+
+OTTDSemaphore *OTTDCreateSemaphore();
+void           OTTDDestroySemaphore(OTTDSemaphore*);
+void           OTTDSignalSemaphore(OTTDSemaphore*);
+void           OTTDWaitSemaphore(OTTDSemaphore*);
+
 #endif /* THREAD_H */
@@ -6,10 +6,19 @@
 #include "openttd.h"
 #include "tile_map.h"
 #include "core/math_func.hpp"
+#include "slope_func.h"
 
 #include "safeguards.h"
 
-Slope GetTileSlope(TileIndex tile, uint *h)
+/**
+ * Compute the slope of a tile and the height of its lowest corner from the
+ * heights of its four corners, bypassing the slope cache.
+ * @param tile the tile to compute the slope of
+ * @param h    if not NULL, the height of the lowest corner in pixels is stored here
+ * @pre tile < MapSize()
+ * @return the slope of the tile
+ */
+Slope ComputeTileSlope(TileIndex tile, uint *h)
 {
 	uint a;
 	uint b;
@@ -44,27 +53,55 @@ Slope GetTileSlope(TileIndex tile, uint *h)
 	return (Slope)r;
 }
 
-uint GetTileZ(TileIndex tile)
+/**
+ * Get the height of the highest corner of a tile.
+ * @param t the tile to get the height of
+ * @pre t < MapSize()
+ * @return the height of the highest corner in pixels
+ */
+uint GetTileMaxZ(TileIndex t)
 {
-	if (TileX(tile) == MapMaxX() || TileY(tile) == MapMaxY()) return 0;
-
-	uint h = TileHeight(tile);
-	h = min(h, TileHeight(tile + TileDiffXY(1, 0)));
-	h = min(h, TileHeight(tile + TileDiffXY(0, 1)));
-	h = min(h, TileHeight(tile + TileDiffXY(1, 1)));
-
-	return h * TILE_HEIGHT;
+	uint h;
+	Slope tileh = GetTileSlope(t, &h);
+	return h + GetSlopeMaxZ(tileh);
 }
 
+/**
+ * Recompute the cached slope of a single tile.
+ * @param tile the tile to update
+ */
+static inline void UpdateSingleTileSlopeCache(TileIndex tile)
+{
+	uint h;
+	Slope tileh = ComputeTileSlope(tile, &h);
+	_map_slope[tile] = tileh | (h / TILE_HEIGHT) << 8;
+}
 
-uint GetTileMaxZ(TileIndex t)
+/**
+ * Update the cached slopes after the height of a tile has been changed.
+ * The height of a tile is the height of its northern corner, which is shared
+ * with the tiles to the north-east, north-west and north of it.
+ * @param tile the tile whose height changed
+ */
+void UpdateTileSlopeCache(TileIndex tile)
 {
-	if (TileX(t) == MapMaxX() || TileY(t) == MapMaxY()) return 0;
+	uint x = TileX(tile);
+	uint y = TileY(tile);
 
-	uint h = TileHeight(t);
-	h = max(h, TileHeight(t + TileDiffXY(1, 0)));
-	h = max(h, TileHeight(t + TileDiffXY(0, 1)));
-	h = max(h, TileHeight(t + TileDiffXY(1, 1)));
+	UpdateSingleTileSlopeCache(tile);
+	if (x > 0) UpdateSingleTileSlopeCache(tile - TileDiffXY(1, 0));
+	if (y > 0) UpdateSingleTileSlopeCache(tile - TileDiffXY(0, 1));
+	if (x > 0 && y > 0) UpdateSingleTileSlopeCache(tile - TileDiffXY(1, 1));
+}
 
-	return h * TILE_HEIGHT;
+/**
+ * Recompute the cached slopes of the whole map. This is needed after
+ * the heights were written without SetTileHeight, like when loading a
+ * game or by the original terrain generator.
+ */
+void RebuildTileSlopeCache()
+{
+	for (TileIndex tile = 0; tile < MapSize(); tile++) {
+		UpdateSingleTileSlopeCache(tile);
+	}
 }
@@ -11,6 +11,9 @@
 #include "map_func.h"
 #include "core/bitmath_func.hpp"
 
+void UpdateTileSlopeCache(TileIndex tile);
+void RebuildTileSlopeCache();
+
 /**
  * Returns the height of a tile
  *
@@ -32,6 +35,7 @@ static inline uint TileHeight(TileIndex tile)
  * Sets the height of a tile.
  *
  * This function sets the height of the northern corner of a tile.
+ * The cached slopes of the tiles sharing this corner are updated too.
  *
  * @param tile The tile to change the height
  * @param height The new height value of the tile
@@ -43,6 +47,7 @@ static inline void SetTileHeight(TileIndex tile, uint height)
 	assert(tile < MapSize());
 	assert(height <= MAX_TILE_HEIGHT);
 	SB(_m[tile].type_height, 0, 4, height);
+	UpdateTileSlopeCache(tile);
 }
 
 /**
@@ -194,8 +199,41 @@ static inline TropicZone GetTropicZone(TileIndex tile)
 	return (TropicZone)GB(_m[tile].m6, 0, 2);
 }
 
-Slope GetTileSlope(TileIndex tile, uint *h);
-uint GetTileZ(TileIndex tile);
+Slope ComputeTileSlope(TileIndex tile, uint *h);
+
+/**
+ * Get the slope of a tile and the height of its lowest corner.
+ * This reads the slope cache, which is kept up to date by SetTileHeight.
+ * @param tile the tile to get the slope of
+ * @param h    if not NULL, the height of the lowest corner in pixels is stored here
+ * @pre tile < MapSize()
+ * @return the slope of the tile
+ */
+static inline Slope GetTileSlope(TileIndex tile, uint *h)
+{
+	assert(tile < MapSize());
+#ifdef _DEBUG
+	uint check_h;
+	Slope check = ComputeTileSlope(tile, &check_h);
+	assert((uint)check == GB(_map_slope[tile], 0, 8) && check_h == GB(_map_slope[tile], 8, 4) * TILE_HEIGHT);
+#endif /* _DEBUG */
+	if (h != NULL) *h = GB(_map_slope[tile], 8, 4) * TILE_HEIGHT;
+	return (Slope)GB(_map_slope[tile], 0, 8);
+}
+
+/**
+ * Get the height of the lowest corner of a tile.
+ * @param tile the tile to get the height of
+ * @pre tile < MapSize()
+ * @return the height of the lowest corner in pixels
+ */
+static inline uint GetTileZ(TileIndex tile)
+{
+	uint h;
+	GetTileSlope(tile, &h);
+	return h;
+}
+
 uint GetTileMaxZ(TileIndex tile);
 
 #endif /* TILE_TYPE_H */
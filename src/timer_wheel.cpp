@@ -0,0 +1,133 @@
+/* $Id$ */
+
+/** @file timer_wheel.cpp Deterministic scheduling of per-object periodic game events. */
+
+#include "stdafx.h"
+#include "openttd.h"
+#include "timer_wheel.h"
+#include "core/alloc_func.hpp"
+
+#include "safeguards.h"
+
+/**
+ * Create an empty wheel.
+ * @param proc the handler of all events scheduled in this wheel
+ */
+TimerWheel::TimerWheel(TimerWheelProc *proc) : proc(proc), now(0), events(NULL), size(0)
+{
+}
+
+TimerWheel::~TimerWheel()
+{
+	free(this->events);
+}
+
+/**
+ * Schedule the event of an object, replacing any event it already had.
+ * @param index the object to schedule the event for
+ * @param delay number of ticks from now, 1 being the next call to Tick()
+ */
+void TimerWheel::Schedule(uint index, uint delay)
+{
+	assert(delay != 0);
+
+	if (index >= this->size) {
+		uint new_size = Align(index + 1, 64);
+		this->events = ReallocT(this->events, new_size);
+		for (uint i = this->size; i < new_size; i++) this->events[i].scheduled = false;
+		this->size = new_size;
+	}
+
+	Event *e = &this->events[index];
+	e->due = this->now + delay;
+	e->scheduled = true;
+	*this->slots[e->due % WHEEL_SLOTS].Append() = index;
+}
+
+/**
+ * Drop the pending event of an object, if any.
+ * The entry in the wheel is left behind and skipped when its slot comes up.
+ * @param index the object to cancel the event of
+ */
+void TimerWheel::Cancel(uint index)
+{
+	if (index < this->size) this->events[index].scheduled = false;
+}
+
+/**
+ * Get the number of ticks until the pending event of an object fires.
+ * @param index the object to get the event of
+ * @return the ticks until the event, 1 being the next call to Tick()
+ * @pre IsScheduled(index)
+ */
+uint TimerWheel::GetRemaining(uint index) const
+{
+	assert(this->IsScheduled(index));
+	return this->events[index].due - this->now;
+}
+
+static int CDECL CompareTimerWheelIndex(const void *a, const void *b)
+{
+	uint ia = *(const uint*)a;
+	uint ib = *(const uint*)b;
+	return (ia > ib) - (ia < ib);
+}
+
+/**
+ * Advance the wheel by one tick and fire all events that are due on it.
+ */
+void TimerWheel::Tick()
+{
+	this->now++;
+
+	/* Split the slot in the events that fire now and the ones that are
+	 * due on a later revolution; stale entries are dropped here too. */
+	SmallVector<uint, 8> *slot = &this->slots[this->now % WHEEL_SLOTS];
+	uint kept = 0;
+	this->firing.Clear();
+	for (uint i = 0; i < slot->Length(); i++) {
+		uint index = (*slot)[i];
+		const Event *e = &this->events[index];
+		if (!e->scheduled || e->due % WHEEL_SLOTS != this->now % WHEEL_SLOTS) continue;
+
+		if (e->due == this->now) {
+			*this->firing.Append() = index;
+		} else {
+			(*slot)[kept++] = index;
+		}
+	}
+	slot->items = kept;
+
+	if (this->firing.Length() == 0) return;
+
+	/* Rescheduling an object can leave duplicate entries behind, and the
+	 * order in which objects were scheduled is not part of the game state. */
+	qsort(this->firing.Begin(), this->firing.Length(), sizeof(uint), CompareTimerWheelIndex);
+
+	for (uint i = 0; i < this->firing.Length(); i++) {
+		uint index = this->firing[i];
+		if (i > 0 && this->firing[i - 1] == index) continue;
+
+		/* An earlier handler may have cancelled or moved this event */
+		const Event *e = &this->events[index];
+		if (!e->scheduled || e->due != this->now) continue;
+
+		/* The handler may schedule other objects, which can move 'events' */
+		uint delay = this->proc(index);
+		if (delay == 0) {
+			this->events[index].scheduled = false;
+		} else {
+			this->Schedule(index, delay);
+		}
+	}
+}
+
+/**
+ * Drop all events and reset the time of the wheel to 0.
+ */
+void TimerWheel::Clear()
+{
+	for (uint i = 0; i < WHEEL_SLOTS; i++) this->slots[i].Clear();
+	for (uint i = 0; i < this->size; i++) this->events[i].scheduled = false;
+	this->now = 0;
+}
@@ -0,0 +1,77 @@
+/* $Id$ */
+
+/** @file timer_wheel.h Deterministic scheduling of per-object periodic game events. */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "misc/smallvec.h"
+
+/**
+ * Handler of a timer wheel event.
+ * @param index the pool index of the object the event was scheduled for
+ * @return number of ticks until the event should fire again, or 0 to drop it
+ */
+typedef uint TimerWheelProc(uint index);
+
+/**
+ * Hashed timer wheel that fires per-object events on the tick they are due,
+ * instead of letting every object poll its own counter each tick.
+ *
+ * Each object (identified by its pool index) has at most one pending event.
+ * Events due on the same tick are always fired in ascending index order, so
+ * the outcome only depends on when events are due and never on the order in
+ * which they were scheduled. Rebuilding a wheel from saved object state
+ * therefore gives exactly the same game as the wheel it was saved from.
+ *
+ * The wheel itself is not saved; its time starts at 0 whenever it is cleared.
+ * Users have to store their counters relative to GetTime() and convert them
+ * back when saving.
+ */
+class TimerWheel {
+public:
+	TimerWheel(TimerWheelProc *proc);
+	~TimerWheel();
+
+	void Schedule(uint index, uint delay);
+	void Cancel(uint index);
+
+	/**
+	 * Is an event pending for the given object?
+	 * @param index the object to check
+	 * @return true when an event is pending
+	 */
+	inline bool IsScheduled(uint index) const
+	{
+		return index < this->size && this->events[index].scheduled;
+	}
+
+	uint GetRemaining(uint index) const;
+
+	/**
+	 * Get the number of ticks that have passed since the wheel was cleared.
+	 * @return the current time of the wheel
+	 */
+	inline uint32 GetTime() const { return this->now; }
+
+	void Tick();
+	void Clear();
+
+private:
+	static const uint WHEEL_SLOTS = 256; ///< Number of slots; events further away wait for the wheel to come around
+
+	/** The pending event of an object. */
+	struct Event {
+		uint32 due;     ///< Tick the event fires on
+		bool scheduled; ///< Whether there is an event at all
+	};
+
+	TimerWheelProc *proc;              ///< Handler of all events in this wheel
+	uint32 now;                        ///< Ticks since the wheel was cleared
+	Event *events;                     ///< Pending event per object index
+	uint size;                         ///< Number of entries in events
+	SmallVector<uint, 8> slots[WHEEL_SLOTS]; ///< Indices that may be due on a tick with the given low bits; may contain stale entries
+	SmallVector<uint, 32> firing;      ///< Indices firing on the current tick
+};
+
+#endif /* TIMER_WHEEL_H */
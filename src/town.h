@@ -304,7 +304,7 @@ static inline Town *GetRandomTown()
 
 Town *CalcClosestTownFromTile(TileIndex tile, uint threshold);
 
-#define FOR_ALL_TOWNS_FROM(t, start) for (t = GetTown(start); t != NULL; t = (t->index + 1U < GetTownPoolSize()) ? GetTown(t->index + 1U) : NULL) if (t->IsValid())
+#define FOR_ALL_TOWNS_FROM(t, start) for (t = _Town_pool.GetNextLive(start); t != NULL; t = _Town_pool.GetNextLive(t->index + 1U)) if (t->IsValid())
 #define FOR_ALL_TOWNS(t) FOR_ALL_TOWNS_FROM(t, 0)
 
 extern bool _town_sort_dirty;
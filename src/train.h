@@ -285,7 +285,7 @@ void CheckTrainsLengths();
  */
 struct Train : public Vehicle {
 	/** Initializes the Vehicle to a train */
-	Train() { this->type = VEH_TRAIN; }
+	Train() { this->type = VEH_TRAIN; UpdateVehicleTickList(this); }
 
 	/** We want to 'destruct' the right class. */
 	virtual ~Train() { this->PreDestructor(); }
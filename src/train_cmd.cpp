@@ -1389,6 +1389,7 @@ CommandCost CmdStartStopTrain(TileIndex tile, uint32 flags, uint32 p1, uint32 p2
 			DeleteVehicleNews(p1, STR_8814_TRAIN_IS_WAITING_IN_DEPOT);
 		}
 
+		WakeVehicle(v);
 		v->vehstatus ^= VS_STOPPED;
 		InvalidateWindowWidget(WC_VEHICLE_VIEW, v->index, VVW_WIDGET_START_STOP_VEH);
 		InvalidateWindow(WC_VEHICLE_DEPOT, v->tile);
@@ -1885,6 +1886,9 @@ static void AdvanceWagonsAfterSwap(Vehicle *v)
 
 static void ReverseTrainDirection(Vehicle *v)
 {
+	/* The junctions ahead are behind the train now */
+	v->u.rail.route.length = 0;
+
 	if (IsTileDepotType(v->tile, TRANSPORT_RAIL)) {
 		InvalidateWindowData(WC_VEHICLE_DEPOT, v->tile);
 	}
@@ -1966,6 +1970,7 @@ CommandCost CmdReverseTrainDirection(TileIndex tile, uint32 flags, uint32 p1, ui
 		if (v->vehstatus & VS_CRASHED || v->breakdown_ctr != 0) return CMD_ERROR;
 
 		if (flags & DC_EXEC) {
+			WakeVehicle(v);
 			if (_patches.realistic_acceleration && v->cur_speed != 0) {
 				ToggleBit(v->u.rail.flags, VRF_REVERSING);
 			} else {
@@ -1993,7 +1998,10 @@ CommandCost CmdForceTrainProceed(TileIndex tile, uint32 flags, uint32 p1, uint32
 
 	if (v->type != VEH_TRAIN || !CheckOwnership(v->owner)) return CMD_ERROR;
 
-	if (flags & DC_EXEC) v->u.rail.force_proceed = 0x50;
+	if (flags & DC_EXEC) {
+		WakeVehicle(v);
+		v->u.rail.force_proceed = 0x50;
+	}
 
 	return CommandCost();
 }
@@ -2945,6 +2953,7 @@ static void SetVehicleCrashed(Vehicle *v)
 
 	RebuildVehicleLists();
 
+	WakeVehicle(v);
 	BEGIN_ENUM_WAGONS(v)
 		v->vehstatus |= VS_CRASHED;
 		MarkSingleVehicleDirty(v);
@@ -3650,9 +3659,12 @@ Money Train::GetRunningCost() const
 
 void Train::Tick()
 {
-	if (_age_cargo_skip_counter == 0) this->cargo.AgeCargo();
+	/* Only the first vehicle of a chain is ticked, so handle the rest too */
+	for (Vehicle *u = this; u != NULL; u = u->Next()) {
+		if (_age_cargo_skip_counter == 0) u->cargo.AgeCargo();
 
-	this->tick_counter++;
+		u->tick_counter++;
+	}
 
 	if (IsFrontEngine(this)) {
 		if (!(this->vehstatus & VS_STOPPED)) this->running_ticks++;
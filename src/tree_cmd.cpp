@@ -72,8 +72,10 @@ static bool CanPlantTreesOnTile(TileIndex tile, bool allow_desert)
  * @param type The type of the tree
  * @param count the number of trees (minus 1)
  * @param growth the growth status
+ * @param region the tile loop region planting the trees, or NULL when not
+ *               planted from within a parallel tile loop
  */
-static void PlantTreesOnTile(TileIndex tile, TreeType treetype, uint count, uint growth)
+static void PlantTreesOnTile(TileIndex tile, TreeType treetype, uint count, uint growth, TileLoopRegion *region = NULL)
 {
 	assert(treetype != TREE_INVALID);
 	assert(CanPlantTreesOnTile(tile, true));
@@ -83,7 +85,9 @@ static void PlantTreesOnTile(TileIndex tile, TreeType treetype, uint count, uint
 
 	switch (GetTileType(tile)) {
 		case MP_WATER:
+			/* Ships can't sail on the coast any more */
 			ground = TREE_GROUND_SHORE;
+			TileLoopNotifyTrackLayoutChange(region, tile);
 			break;
 
 		case MP_CLEAR:
@@ -567,13 +571,13 @@ static void AnimateTile_Trees(TileIndex tile)
 	/* not used */
 }
 
-static void TileLoopTreesDesert(TileIndex tile)
+static void TileLoopTreesDesert(TileIndex tile, TileLoopRegion *region)
 {
 	switch (GetTropicZone(tile)) {
 		case TROPICZONE_DESERT:
 			if (GetTreeGround(tile) != TREE_GROUND_SNOW_DESERT) {
 				SetTreeGroundDensity(tile, TREE_GROUND_SNOW_DESERT, 3);
-				MarkTileDirtyByTile(tile);
+				TileLoopMarkDirty(region, tile);
 			}
 			break;
 
@@ -584,9 +588,9 @@ static void TileLoopTreesDesert(TileIndex tile)
 				SND_44_MONKEYS,
 				SND_48_DISTANT_BIRD
 			};
-			uint32 r = Random();
+			uint32 r = TileLoopRandom(region);
 
-			if (Chance16I(1, 200, r)) SndPlayTileFx(forest_sounds[GB(r, 16, 2)], tile);
+			if (Chance16I(1, 200, r)) TileLoopPlaySound(region, forest_sounds[GB(r, 16, 2)], tile);
 			break;
 		}
 
@@ -594,7 +598,7 @@ static void TileLoopTreesDesert(TileIndex tile)
 	}
 }
 
-static void TileLoopTreesAlps(TileIndex tile)
+static void TileLoopTreesAlps(TileIndex tile, TileLoopRegion *region)
 {
 	int k = GetTileZ(tile) - GetSnowLine() + TILE_HEIGHT;
 
@@ -609,29 +613,38 @@ static void TileLoopTreesAlps(TileIndex tile)
 			SetTreeGroundDensity(tile, TREE_GROUND_SNOW_DESERT, density);
 		} else {
 			if (GetTreeDensity(tile) == 3) {
-				uint32 r = Random();
+				uint32 r = TileLoopRandom(region);
 				if (Chance16I(1, 200, r)) {
-					SndPlayTileFx((r & 0x80000000) ? SND_39_HEAVY_WIND : SND_34_WIND, tile);
+					TileLoopPlaySound(region, (r & 0x80000000) ? SND_39_HEAVY_WIND : SND_34_WIND, tile);
 				}
 			}
 			return;
 		}
 	}
-	MarkTileDirtyByTile(tile);
+	TileLoopMarkDirty(region, tile);
 }
 
-static void TileLoop_Trees(TileIndex tile)
+/**
+ * Tile loop of a tree tile.
+ * @param tile   the tile to loop
+ * @param region the tile loop region the tile belongs to, or NULL when
+ *               the tile loop runs serially
+ * @pre region == NULL || GetTreeGround(tile) != TREE_GROUND_SHORE
+ */
+void TileLoopTrees(TileIndex tile, TileLoopRegion *region)
 {
 	if (GetTreeGround(tile) == TREE_GROUND_SHORE) {
+		/* Flooding is not local to the tile */
+		assert(region == NULL);
 		TileLoop_Water(tile);
 	} else {
 		switch (_opt.landscape) {
-			case LT_TROPIC: TileLoopTreesDesert(tile); break;
-			case LT_ARCTIC: TileLoopTreesAlps(tile);   break;
+			case LT_TROPIC: TileLoopTreesDesert(tile, region); break;
+			case LT_ARCTIC: TileLoopTreesAlps(tile, region);   break;
 		}
 	}
 
-	TileLoopClearHelper(tile);
+	TileLoopClearHelper(tile, region);
 
 	uint treeCounter = GetTreeCounter(tile);
 
@@ -640,7 +653,7 @@ static void TileLoop_Trees(TileIndex tile)
 		uint density = GetTreeDensity(tile);
 		if (density < 3) {
 			SetTreeGroundDensity(tile, TREE_GROUND_GRASS, density + 1);
-			MarkTileDirtyByTile(tile);
+			TileLoopMarkDirty(region, tile);
 		}
 	}
 	if (GetTreeCounter(tile) < 15) {
@@ -656,7 +669,7 @@ static void TileLoop_Trees(TileIndex tile)
 					GetTropicZone(tile) == TROPICZONE_DESERT) {
 				AddTreeGrowth(tile, 1);
 			} else {
-				switch (GB(Random(), 0, 3)) {
+				switch (GB(TileLoopRandom(region), 0, 3)) {
 					case 0: /* start destructing */
 						AddTreeGrowth(tile, 1);
 						break;
@@ -672,7 +685,7 @@ static void TileLoop_Trees(TileIndex tile)
 					case 2: { /* add a neighbouring tree */
 						TreeType treetype = GetTreeType(tile);
 
-						tile += TileOffsByDir((Direction)(Random() & 7));
+						tile += TileOffsByDir((Direction)(TileLoopRandom(region) & 7));
 
 						/* Cacti don't spread */
 						if (!CanPlantTreesOnTile(tile, false)) return;
@@ -680,7 +693,7 @@ static void TileLoop_Trees(TileIndex tile)
 						/* Don't plant trees, if ground was freshly cleared */
 						if (IsTileType(tile, MP_CLEAR) && GetClearGround(tile) == CLEAR_GRASS && GetClearDensity(tile) != 3) return;
 
-						PlantTreesOnTile(tile, treetype, 0, 0);
+						PlantTreesOnTile(tile, treetype, 0, 0, region);
 
 						break;
 					}
@@ -699,7 +712,10 @@ static void TileLoop_Trees(TileIndex tile)
 			} else {
 				/* just one tree, change type into MP_CLEAR */
 				switch (GetTreeGround(tile)) {
-					case TREE_GROUND_SHORE: MakeShore(tile); break;
+					case TREE_GROUND_SHORE:
+						MakeShore(tile);
+						TileLoopNotifyTrackLayoutChange(region, tile);
+						break;
 					case TREE_GROUND_GRASS: MakeClear(tile, CLEAR_GRASS, GetTreeDensity(tile)); break;
 					case TREE_GROUND_ROUGH: MakeClear(tile, CLEAR_ROUGH, 3); break;
 					default: // snow or desert
@@ -714,7 +730,12 @@ static void TileLoop_Trees(TileIndex tile)
 			break;
 	}
 
-	MarkTileDirtyByTile(tile);
+	TileLoopMarkDirty(region, tile);
+}
+
+static void TileLoop_Trees(TileIndex tile)
+{
+	TileLoopTrees(tile, NULL);
 }
 
 void OnTick_Trees()
@@ -429,6 +429,10 @@ not_valid_below:;
 		Track track = AxisToTrack(direction);
 		AddSideToSignalBuffer(tile_start, INVALID_DIAGDIR, _current_player);
 		YapfNotifyTrackLayoutChange(tile_start, track);
+		YapfNotifyTrackLayoutChange(tile_end, track);
+	} else if (flags & DC_EXEC) {
+		YapfNotifyTrackLayoutChange(tile_start, INVALID_TRACK);
+		YapfNotifyTrackLayoutChange(tile_end, INVALID_TRACK);
 	}
 
 	/* for human player that builds the bridge he gets a selection to choose from bridges (DC_QUERY_COST)
@@ -556,9 +560,12 @@ CommandCost CmdBuildTunnel(TileIndex start_tile, uint32 flags, uint32 p1, uint32
 			MakeRailTunnel(end_tile,   _current_player, ReverseDiagDir(direction), (RailType)GB(p1, 0, 4));
 			AddSideToSignalBuffer(start_tile, INVALID_DIAGDIR, _current_player);
 			YapfNotifyTrackLayoutChange(start_tile, AxisToTrack(DiagDirToAxis(direction)));
+			YapfNotifyTrackLayoutChange(end_tile, AxisToTrack(DiagDirToAxis(direction)));
 		} else {
 			MakeRoadTunnel(start_tile, _current_player, direction,                 (RoadTypes)GB(p1, 0, 3));
 			MakeRoadTunnel(end_tile,   _current_player, ReverseDiagDir(direction), (RoadTypes)GB(p1, 0, 3));
+			YapfNotifyTrackLayoutChange(start_tile, INVALID_TRACK);
+			YapfNotifyTrackLayoutChange(end_tile, INVALID_TRACK);
 		}
 	}
 
@@ -626,6 +633,8 @@ static CommandCost DoClearTunnel(TileIndex tile, uint32 flags)
 		} else {
 			DoClearSquare(tile);
 			DoClearSquare(endtile);
+			YapfNotifyTrackLayoutChange(tile,    INVALID_TRACK);
+			YapfNotifyTrackLayoutChange(endtile, INVALID_TRACK);
 		}
 	}
 	return CommandCost(EXPENSES_CONSTRUCTION, _price.clear_tunnel * (GetTunnelBridgeLength(tile, endtile) + 2));
@@ -691,6 +700,9 @@ static CommandCost DoClearBridge(TileIndex tile, uint32 flags)
 			Track track = AxisToTrack(DiagDirToAxis(direction));
 			YapfNotifyTrackLayoutChange(tile,    track);
 			YapfNotifyTrackLayoutChange(endtile, track);
+		} else {
+			YapfNotifyTrackLayoutChange(tile,    INVALID_TRACK);
+			YapfNotifyTrackLayoutChange(endtile, INVALID_TRACK);
 		}
 	}
 
@@ -48,6 +48,7 @@
 #include "autoreplace_gui.h"
 #include "string_func.h"
 #include "settings_type.h"
+#include "meminfo.h"
 
 #include "table/sprites.h"
 #include "table/strings.h"
@@ -55,7 +56,6 @@
 #include "safeguards.h"
 
 #define INVALID_COORD (0x7fffffff)
-#define GEN_HASH(x, y) ((GB((y), 6, 6) << 6) + GB((x), 7, 6))
 
 VehicleID _vehicle_id_ctr_day;
 Vehicle *_place_clicked_vehicle;
@@ -212,6 +212,201 @@ void VehiclePositionChanged(Vehicle *v)
 	v->bottom_coord = pt.y + spr->height + 2;
 }
 
+/**
+ * Bitmap, indexed by vehicle index, of the vehicles that need to be ticked.
+ * Only the first vehicle of a train, road vehicle, ship or aircraft chain
+ * is ticked, and only when it is not dormant; the other parts are handled
+ * by it. Walking the bitmap visits the
+ * vehicles in the same order as FOR_ALL_VEHICLES does.
+ */
+static uint32 *_vehicle_tick_list = NULL;
+static uint _vehicle_tick_list_size = 0; ///< Size of _vehicle_tick_list in 32 bit words
+
+/**
+ * Does the given vehicle have to be ticked by CallVehicleTicks?
+ * @param v the vehicle to check
+ * @return true if the vehicle has to be ticked
+ */
+static bool NeedsVehicleTick(const Vehicle *v)
+{
+	switch (v->type) {
+		case VEH_INVALID:
+			return false;
+
+		case VEH_TRAIN:
+		case VEH_ROAD:
+		case VEH_SHIP:
+		case VEH_AIRCRAFT:
+			return v->First() == v && !v->dormant;
+
+		default:
+			return true;
+	}
+}
+
+/**
+ * Add a vehicle to, or remove it from, the list of vehicles to tick,
+ * depending on its type and position in its chain.
+ * @param v the vehicle that changed
+ */
+void UpdateVehicleTickList(const Vehicle *v)
+{
+	uint word = v->index / 32;
+
+	if (NeedsVehicleTick(v)) {
+		if (word >= _vehicle_tick_list_size) {
+			uint size = Align(word + 1, 64);
+			_vehicle_tick_list = ReallocT(_vehicle_tick_list, size);
+			memset(_vehicle_tick_list + _vehicle_tick_list_size, 0, (size - _vehicle_tick_list_size) * sizeof(*_vehicle_tick_list));
+			_vehicle_tick_list_size = size;
+		}
+		SetBit(_vehicle_tick_list[word], v->index % 32);
+	} else if (word < _vehicle_tick_list_size) {
+		ClrBit(_vehicle_tick_list[word], v->index % 32);
+	}
+}
+
+/** Rebuild the list of vehicles to tick from scratch, e.g. after loading. */
+static void RebuildVehicleTickList()
+{
+	if (_vehicle_tick_list != NULL) memset(_vehicle_tick_list, 0, _vehicle_tick_list_size * sizeof(*_vehicle_tick_list));
+
+	Vehicle *v;
+	FOR_ALL_VEHICLES(v) UpdateVehicleTickList(v);
+}
+
+static uint32 _vehicle_tick_count = 0;                   ///< Number of finished CallVehicleTicks
+static uint32 _vehicle_cargo_age_count = 0;              ///< Number of those that aged cargo
+static VehicleID _vehicle_tick_index = INVALID_VEHICLE;  ///< Vehicle being ticked by CallVehicleTicks
+
+/**
+ * Get the number of ticks and cargo agings a vehicle has had so far.
+ * During CallVehicleTicks the current tick counts for the vehicles it
+ * already passed, just like it would when the vehicle was ticked.
+ * @param v the vehicle
+ * @param ticks receives the number of vehicle ticks
+ * @param ages receives the number of cargo agings
+ */
+static void GetVehicleTickProgress(const Vehicle *v, uint32 *ticks, uint32 *ages)
+{
+	*ticks = _vehicle_tick_count;
+	*ages  = _vehicle_cargo_age_count;
+
+	if (_vehicle_tick_index != INVALID_VEHICLE && v->index <= _vehicle_tick_index) {
+		(*ticks)++;
+		if (_age_cargo_skip_counter == 0) (*ages)++;
+	}
+}
+
+/**
+ * Check whether a vehicle can be taken off the tick schedule. That is the
+ * case for vehicles stopped in a depot, as their tick only advances some
+ * counters, which WakeVehicle can catch up on later.
+ * @param v the first vehicle of the chain
+ * @return true if the vehicle can become dormant
+ */
+static bool CanVehicleSleep(const Vehicle *v)
+{
+	if ((v->vehstatus & (VS_STOPPED | VS_CRASHED)) != VS_STOPPED) return false;
+	if (v->cur_speed != 0 || v->breakdown_ctr != 0) return false;
+
+	switch (v->type) {
+		case VEH_TRAIN:
+			if (v->u.rail.force_proceed != 0 || HasBit(v->u.rail.flags, VRF_REVERSING)) return false;
+			break;
+
+		case VEH_ROAD:
+			if (v->u.road.reverse_ctr != 0) return false;
+			break;
+
+		case VEH_SHIP:
+		case VEH_AIRCRAFT:
+			break;
+
+		default:
+			return false;
+	}
+
+	return v->IsStoppedInDepot();
+}
+
+/**
+ * Apply the ticks a dormant vehicle missed so far.
+ * @param v the dormant vehicle
+ */
+static void CatchUpDormantVehicle(Vehicle *v)
+{
+	uint32 ticks, ages;
+	GetVehicleTickProgress(v, &ticks, &ages);
+
+	ticks -= v->dormant_ticks;
+	ages  -= v->dormant_cargo_ages;
+	v->dormant_ticks += ticks;
+	v->dormant_cargo_ages += ages;
+
+	/* Cargo stops aging after 255 days anyway */
+	ages = min<uint32>(ages, 0xFF);
+
+	for (Vehicle *u = v; u != NULL; u = u->Next()) {
+		for (uint i = 0; i != ages; i++) u->cargo.AgeCargo();
+		if (u->type == VEH_TRAIN) u->tick_counter += ticks;
+	}
+
+	switch (v->type) {
+		default: NOT_REACHED();
+		case VEH_TRAIN:    if (IsFrontEngine(v)) v->current_order_time += ticks; break;
+		case VEH_ROAD:
+		case VEH_SHIP:     v->tick_counter += ticks;     v->current_order_time += ticks; break;
+		case VEH_AIRCRAFT: v->tick_counter += 2 * ticks; v->current_order_time += ticks; break;
+	}
+}
+
+/**
+ * Put a vehicle back on the tick schedule, when it is dormant.
+ * Needs to be called before anything changes the state of a vehicle
+ * that could make CanVehicleSleep false, or uses the counters that are
+ * not advanced while dormant.
+ * @param v the vehicle, or any part of it
+ */
+void WakeVehicle(Vehicle *v)
+{
+	v = v->First();
+	if (!v->dormant) return;
+
+	CatchUpDormantVehicle(v);
+	v->dormant = false;
+	UpdateVehicleTickList(v);
+}
+
+/** Bring the counters of all dormant vehicles up to date, e.g. before saving. */
+void CatchUpDormantVehicles()
+{
+	Vehicle *v;
+	FOR_ALL_VEHICLES(v) {
+		if (v->dormant) CatchUpDormantVehicle(v);
+	}
+}
+
+/**
+ * Get the tick counter of a vehicle, including the ticks it missed
+ * while dormant.
+ * @param v the vehicle
+ * @return the tick counter
+ */
+byte GetVehicleTickCounter(const Vehicle *v)
+{
+	const Vehicle *first = v->First();
+	if (!first->dormant) return v->tick_counter;
+
+	uint32 ticks, ages;
+	GetVehicleTickProgress(first, &ticks, &ages);
+	ticks -= first->dormant_ticks;
+
+	if (v->type == VEH_TRAIN) return v->tick_counter + ticks;
+	if (v != first) return v->tick_counter;
+	return v->tick_counter + (v->type == VEH_AIRCRAFT ? 2 * ticks : ticks);
+}
+
 /** Called after load to update coordinates */
 void AfterLoadVehicles(bool clear_te_id)
 {
@@ -240,6 +435,8 @@ void AfterLoadVehicles(bool clear_te_id)
 		}
 	}
 
+	RebuildVehicleTickList();
+
 	FOR_ALL_VEHICLES(v) {
 		assert(v->first != NULL);
 
@@ -295,6 +492,7 @@ Vehicle::Vehicle()
 	this->fill_percent_te_id = INVALID_TE_ID;
 	this->first              = this;
 	this->colormap           = PAL_NONE;
+	this->dormant            = false;
 }
 
 /**
@@ -326,32 +524,70 @@ byte VehicleRandomBits()
 	return true;
 }
 
-/* Size of the hash, 6 = 64 x 64, 7 = 128 x 128. Larger sizes will (in theory) reduce hash
- * lookup times at the expense of memory usage. */
-const int HASH_BITS = 7;
-const int HASH_SIZE = 1 << HASH_BITS;
-const int HASH_MASK = HASH_SIZE - 1;
-const int TOTAL_HASH_SIZE = 1 << (HASH_BITS * 2);
-const int TOTAL_HASH_MASK = TOTAL_HASH_SIZE - 1;
+/* The hash of vehicle positions wraps the tile coordinates modulo its size.
+ * Its size only depends on the map, so a client that joins a game ends up
+ * with the same hash as the server: the map itself, but no more than
+ * MAX_HASH_BITS buckets in total, taken from both axes alike. It is
+ * never resized while vehicles are being looked up or moved. */
+static const uint MAX_HASH_BITS = 18; ///< Maximum number of bits of both axes together
+
+static Vehicle **_new_vehicle_position_hash = NULL; ///< Chains of vehicles, indexed by (y << _pos_hash_bits_x) + x
+static uint _pos_hash_bits_x = 0; ///< Number of bits of the X coordinate of the tile used by the hash
+static uint _pos_hash_bits_y = 0; ///< Number of bits of the Y coordinate of the tile used by the hash
+static uint _pos_hash_count  = 0; ///< Number of vehicles in the hash
+
+/**
+ * Get the chain of the hash of vehicle positions a tile is in.
+ * @param x the X coordinate of the tile
+ * @param y the Y coordinate of the tile
+ * @return the first vehicle of the chain
+ */
+static inline Vehicle **GetVehiclePosHash(uint x, uint y)
+{
+	return &_new_vehicle_position_hash[(GB(y, 0, _pos_hash_bits_y) << _pos_hash_bits_x) + GB(x, 0, _pos_hash_bits_x)];
+}
+
+/**
+ * Allocate an empty hash of vehicle positions sized for the current map.
+ * All vehicles are marked as not being in the hash.
+ */
+static void AllocateVehiclePosHash()
+{
+	uint bits_x = MapLogX();
+	uint bits_y = MapLogY();
+	while (bits_x + bits_y > MAX_HASH_BITS) {
+		if (bits_x >= bits_y) {
+			bits_x--;
+		} else {
+			bits_y--;
+		}
+	}
 
-/* Resolution of the hash, 0 = 1*1 tile, 1 = 2*2 tiles, 2 = 4*4 tiles, etc.
- * Profiling results show that 0 is fastest. */
-const int HASH_RES = 0;
+	free(_new_vehicle_position_hash);
+	_new_vehicle_position_hash = CallocT<Vehicle*>(1 << (bits_x + bits_y));
+	_pos_hash_bits_x = bits_x;
+	_pos_hash_bits_y = bits_y;
+	_pos_hash_count = 0;
 
-static Vehicle *_new_vehicle_position_hash[TOTAL_HASH_SIZE];
+	Vehicle *v;
+	FOR_ALL_VEHICLES(v) v->old_new_hash = NULL;
+}
 
-static void *VehicleFromHash(int xl, int yl, int xu, int yu, void *data, VehicleFromPosProc *proc, bool find_first)
+static void *VehicleFromHash(uint xl, uint yl, uint xu, uint yu, void *data, VehicleFromPosProc *proc, bool find_first)
 {
-	for (int y = yl; ; y = (y + (1 << HASH_BITS)) & (HASH_MASK << HASH_BITS)) {
-		for (int x = xl; ; x = (x + 1) & HASH_MASK) {
-			Vehicle *v = _new_vehicle_position_hash[(x + y) & TOTAL_HASH_MASK];
+	uint mask_x = (1 << _pos_hash_bits_x) - 1;
+	uint mask_y = (1 << _pos_hash_bits_y) - 1;
+
+	for (uint y = yl & mask_y; ; y = (y + 1) & mask_y) {
+		for (uint x = xl & mask_x; ; x = (x + 1) & mask_x) {
+			Vehicle *v = *GetVehiclePosHash(x, y);
 			for (; v != NULL; v = v->next_new_hash) {
 				void *a = proc(v, data);
 				if (find_first && a != NULL) return a;
 			}
-			if (x == xu) break;
+			if (x == (xu & mask_x)) break;
 		}
-		if (y == yu) break;
+		if (y == (yu & mask_y)) break;
 	}
 
 	return NULL;
@@ -374,10 +610,10 @@ static void *VehicleFromPosXY(int x, int y, void *data, VehicleFromPosProc *proc
 	const int COLL_DIST = 6;
 
 	/* Hash area to scan is from xl,yl to xu,yu */
-	int xl = GB((x - COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS);
-	int xu = GB((x + COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS);
-	int yl = GB((y - COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS) << HASH_BITS;
-	int yu = GB((y + COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS) << HASH_BITS;
+	uint xl = (x - COLL_DIST) / TILE_SIZE;
+	uint xu = (x + COLL_DIST) / TILE_SIZE;
+	uint yl = (y - COLL_DIST) / TILE_SIZE;
+	uint yu = (y + COLL_DIST) / TILE_SIZE;
 
 	return VehicleFromHash(xl, yl, xu, yu, data, proc, find_first);
 }
@@ -429,10 +665,7 @@ bool HasVehicleOnPosXY(int x, int y, void *data, VehicleFromPosProc *proc)
  */
 static void *VehicleFromPos(TileIndex tile, void *data, VehicleFromPosProc *proc, bool find_first)
 {
-	int x = GB(TileX(tile), HASH_RES, HASH_BITS);
-	int y = GB(TileY(tile), HASH_RES, HASH_BITS) << HASH_BITS;
-
-	Vehicle *v = _new_vehicle_position_hash[(x + y) & TOTAL_HASH_MASK];
+	Vehicle *v = *GetVehiclePosHash(TileX(tile), TileY(tile));
 	for (; v != NULL; v = v->next_new_hash) {
 		if (v->tile != tile) continue;
 
@@ -485,9 +718,7 @@ static void UpdateNewVehiclePosHash(Vehicle *v, bool remove)
 	if (remove) {
 		new_hash = NULL;
 	} else {
-		int x = GB(TileX(v->tile), HASH_RES, HASH_BITS);
-		int y = GB(TileY(v->tile), HASH_RES, HASH_BITS) << HASH_BITS;
-		new_hash = &_new_vehicle_position_hash[(x + y) & TOTAL_HASH_MASK];
+		new_hash = GetVehiclePosHash(TileX(v->tile), TileY(v->tile));
 	}
 
 	if (old_hash == new_hash) return;
@@ -507,6 +738,7 @@ static void UpdateNewVehiclePosHash(Vehicle *v, bool remove)
 		} else {
 			last->next_new_hash = v->next_new_hash;
 		}
+		if (new_hash == NULL) _pos_hash_count--;
 	}
 
 	/* Insert vehicle at beginning of the new position in the hash table */
@@ -518,9 +750,90 @@ static void UpdateNewVehiclePosHash(Vehicle *v, bool remove)
 
 	/* Remember current hash position */
 	v->old_new_hash = new_hash;
+
+	if (old_hash == NULL) _pos_hash_count++;
+}
+
+/* The hash used to find the vehicles to draw in a viewport divides the
+ * virtual coordinates of the whole map in a grid of buckets, without any
+ * wrapping, so a bucket only holds vehicles that are really near each other.
+ * Vehicles outside the map are put in the buckets at the edge of the grid.
+ * Buckets are 128 x 64 pixels, unless that would need more than
+ * MAX_VIEWPORT_HASH_SIZE buckets; then they are made twice as large until
+ * the grid fits. */
+static const uint VIEWPORT_HASH_SHIFT_X  = 7;       ///< Minimum width of a bucket, as power of two
+static const uint VIEWPORT_HASH_SHIFT_Y  = 6;       ///< Minimum height of a bucket, as power of two
+static const uint MAX_VIEWPORT_HASH_SIZE = 1 << 19; ///< Maximum number of buckets
+static const int VIEWPORT_HASH_MARGIN    = 70;      ///< Maximum width and height of a vehicle sprite; vehicles are hashed by their top left
+
+static Vehicle **_vehicle_position_hash = NULL; ///< Chains of vehicles, indexed by y * _viewport_hash_size_x + x
+static int _viewport_hash_left = 0;     ///< Virtual X coordinate of the left of the grid
+static int _viewport_hash_top = 0;      ///< Virtual Y coordinate of the top of the grid
+static uint _viewport_hash_shift_x = 0; ///< Width of a bucket, as power of two
+static uint _viewport_hash_shift_y = 0; ///< Height of a bucket, as power of two
+static uint _viewport_hash_size_x = 0;  ///< Number of buckets along the X axis
+static uint _viewport_hash_size_y = 0;  ///< Number of buckets along the Y axis
+
+/**
+ * Get the column of the viewport hash a virtual X coordinate is in.
+ * @param x the virtual X coordinate
+ * @return the column, clamped to the grid
+ */
+static inline uint GetViewportHashX(int x)
+{
+	return Clamp((x - _viewport_hash_left) >> _viewport_hash_shift_x, 0, _viewport_hash_size_x - 1);
+}
+
+/**
+ * Get the row of the viewport hash a virtual Y coordinate is in.
+ * @param y the virtual Y coordinate
+ * @return the row, clamped to the grid
+ */
+static inline uint GetViewportHashY(int y)
+{
+	return Clamp((y - _viewport_hash_top) >> _viewport_hash_shift_y, 0, _viewport_hash_size_y - 1);
 }
 
-static Vehicle *_vehicle_position_hash[0x1000];
+/**
+ * Get the chain of the viewport hash a vehicle with its top left at the
+ * given virtual coordinates is in.
+ * @param x the virtual X coordinate
+ * @param y the virtual Y coordinate
+ * @return the first vehicle of the chain
+ */
+static inline Vehicle **GetViewportHash(int x, int y)
+{
+	return &_vehicle_position_hash[GetViewportHashY(y) * _viewport_hash_size_x + GetViewportHashX(x)];
+}
+
+/**
+ * Allocate an empty viewport hash that covers the virtual coordinates of
+ * the current map.
+ */
+static void AllocateViewportHash()
+{
+	/* The corners of the map are at (-MapMaxX() * 32, MapMaxX() * 16) for the
+	 * left, (MapMaxY() * 32, MapMaxY() * 16) for the right and at a Y of
+	 * (MapMaxX() + MapMaxY()) * 16 for the bottom. Heights and vehicles
+	 * flying above the map reach above the top. */
+	_viewport_hash_left = -(int)(MapMaxX() * TILE_SIZE * 2);
+	_viewport_hash_top  = -(int)(TILE_HEIGHT * 32);
+	uint width  = (MapMaxX() + MapMaxY()) * TILE_SIZE * 2;
+	uint height = (MapMaxX() + MapMaxY()) * TILE_SIZE - _viewport_hash_top;
+
+	_viewport_hash_shift_x = VIEWPORT_HASH_SHIFT_X;
+	_viewport_hash_shift_y = VIEWPORT_HASH_SHIFT_Y;
+	for (;;) {
+		_viewport_hash_size_x = (width >> _viewport_hash_shift_x) + 1;
+		_viewport_hash_size_y = (height >> _viewport_hash_shift_y) + 1;
+		if (_viewport_hash_size_x * _viewport_hash_size_y <= MAX_VIEWPORT_HASH_SIZE) break;
+		_viewport_hash_shift_x++;
+		_viewport_hash_shift_y++;
+	}
+
+	free(_vehicle_position_hash);
+	_vehicle_position_hash = CallocT<Vehicle*>(_viewport_hash_size_x * _viewport_hash_size_y);
+}
 
 static void UpdateVehiclePosHash(Vehicle* v, int x, int y)
 {
@@ -530,8 +843,8 @@ static void UpdateVehiclePosHash(Vehicle* v, int x, int y)
 	int old_x = v->left_coord;
 	int old_y = v->top_coord;
 
-	new_hash = (x == INVALID_COORD) ? NULL : &_vehicle_position_hash[GEN_HASH(x, y)];
-	old_hash = (old_x == INVALID_COORD) ? NULL : &_vehicle_position_hash[GEN_HASH(old_x, old_y)];
+	new_hash = (x == INVALID_COORD) ? NULL : GetViewportHash(x, y);
+	old_hash = (old_x == INVALID_COORD) ? NULL : GetViewportHash(old_x, old_y);
 
 	if (old_hash == new_hash) return;
 
@@ -559,12 +872,99 @@ static void UpdateVehiclePosHash(Vehicle* v, int x, int y)
 	}
 }
 
+/**
+ * Empty the hashes of vehicle positions and size them for the current map again.
+ */
 void ResetVehiclePosHash()
 {
-	Vehicle *v;
-	FOR_ALL_VEHICLES(v) { v->old_new_hash = NULL; }
-	memset(_vehicle_position_hash, 0, sizeof(_vehicle_position_hash));
-	memset(_new_vehicle_position_hash, 0, sizeof(_new_vehicle_position_hash));
+	AllocateViewportHash();
+	AllocateVehiclePosHash();
+}
+
+/**
+ * Get statistics about the chains of the hash used to find vehicles on a tile.
+ * @param stats the statistics to fill
+ */
+void GetVehiclePosHashStats(VehicleHashStats *stats)
+{
+	stats->size_x   = 1 << _pos_hash_bits_x;
+	stats->size_y   = 1 << _pos_hash_bits_y;
+	stats->vehicles = _pos_hash_count;
+	stats->used     = 0;
+	stats->longest  = 0;
+	stats->squares  = 0;
+
+	if (_new_vehicle_position_hash == NULL) return;
+
+	for (uint i = 0; i < stats->size_x * stats->size_y; i++) {
+		uint length = 0;
+		for (const Vehicle *v = _new_vehicle_position_hash[i]; v != NULL; v = v->next_new_hash) length++;
+		if (length == 0) continue;
+
+		stats->used++;
+		stats->longest = max(stats->longest, length);
+		stats->squares += (uint64)length * length;
+	}
+}
+
+/**
+ * Get statistics about the chains of the hash used to find the vehicles to
+ * draw in a viewport.
+ * @param stats the statistics to fill
+ */
+void GetViewportVehicleHashStats(VehicleHashStats *stats)
+{
+	stats->size_x   = _viewport_hash_size_x;
+	stats->size_y   = _viewport_hash_size_y;
+	stats->vehicles = 0;
+	stats->used     = 0;
+	stats->longest  = 0;
+	stats->squares  = 0;
+
+	if (_vehicle_position_hash == NULL) return;
+
+	for (uint i = 0; i < stats->size_x * stats->size_y; i++) {
+		uint length = 0;
+		for (const Vehicle *v = _vehicle_position_hash[i]; v != NULL; v = v->next_hash) length++;
+		if (length == 0) continue;
+
+		stats->vehicles += length;
+		stats->used++;
+		stats->longest = max(stats->longest, length);
+		stats->squares += (uint64)length * length;
+	}
+}
+
+/**
+ * Get the memory used by the hash used to find vehicles on a tile.
+ * @param usage the memory usage to fill
+ */
+void GetVehiclePosHashMemoryUsage(MemoryUsage *usage)
+{
+	uint buckets = 1 << (_pos_hash_bits_x + _pos_hash_bits_y);
+
+	usage->name = "vehicle_pos_hash";
+	usage->allocated = (uint64)buckets * sizeof(*_new_vehicle_position_hash);
+	usage->used = usage->allocated;
+	usage->items = _pos_hash_count;
+	usage->capacity = buckets;
+	usage->peak = 0;
+}
+
+/**
+ * Get the memory used by the hash used to find the vehicles to draw in a viewport.
+ * @param usage the memory usage to fill
+ */
+void GetViewportVehicleHashMemoryUsage(MemoryUsage *usage)
+{
+	uint buckets = _viewport_hash_size_x * _viewport_hash_size_y;
+
+	usage->name = "vehicle_viewport_hash";
+	usage->allocated = (uint64)buckets * sizeof(*_vehicle_position_hash);
+	usage->used = usage->allocated;
+	usage->items = 0;
+	usage->capacity = buckets;
+	usage->peak = 0;
 }
 
 void ResetVehicleColorMap()
@@ -578,6 +978,10 @@ void InitializeVehicles()
 	_Vehicle_pool.CleanPool();
 	_Vehicle_pool.AddBlockToPool();
 
+	free(_vehicle_tick_list);
+	_vehicle_tick_list = NULL;
+	_vehicle_tick_list_size = 0;
+
 	ResetVehiclePosHash();
 }
 
@@ -724,6 +1128,20 @@ void VehicleEnteredDepotThisTick(Vehicle *v)
 	}
 }
 
+/**
+ * Update the motion counter of a running vehicle and play its running sounds.
+ * @param v the vehicle
+ */
+static void RunVehicleSounds(Vehicle *v)
+{
+	v->motion_counter += (v->direction & 1) ? (v->cur_speed * 3) / 4 : v->cur_speed;
+	/* Play a running sound if the motion counter passes 256 (Do we not skip sounds?) */
+	if (GB(v->motion_counter, 0, 8) < v->cur_speed) PlayVehicleSound(v, VSE_RUNNING);
+
+	/* Play an alterate running sound every 16 ticks */
+	if (GB(v->tick_counter, 0, 4) == 0) PlayVehicleSound(v, v->cur_speed > 0 ? VSE_RUNNING_16 : VSE_STOPPED_16);
+}
+
 void CallVehicleTicks()
 {
 	_first_veh_in_depot_list = NULL; // now we are sure it's initialized at the start of each tick
@@ -731,32 +1149,59 @@ void CallVehicleTicks()
 	Station *st;
 	FOR_ALL_STATIONS(st) LoadUnloadStation(st);
 
-	Vehicle *v;
-	FOR_ALL_VEHICLES(v) {
+	QueueShipPathSearches();
+
+	/* Vehicles can be added and removed while ticking, so the bitmap is
+	 * re-read after each vehicle; like FOR_ALL_VEHICLES, new vehicles
+	 * after the current one are ticked in this tick as well. */
+	for (uint index = 0; index < _vehicle_tick_list_size * 32;) {
+		uint32 bits = _vehicle_tick_list[index / 32] >> (index % 32);
+		if (bits == 0) {
+			index = (index | 31) + 1;
+			continue;
+		}
+		index += FindFirstBit(bits);
+
+		Vehicle *v = GetVehicle(index++);
+		_vehicle_tick_index = v->index;
 		v->Tick();
 
 		switch (v->type) {
 			default: break;
 
 			case VEH_TRAIN:
+				/* All engines of the train are running, not only the front one */
+				for (Vehicle *u = v; u != NULL; u = u->Next()) {
+					if (!IsTrainWagon(u)) RunVehicleSounds(u);
+				}
+				break;
+
 			case VEH_ROAD:
-			case VEH_AIRCRAFT:
 			case VEH_SHIP:
-				if (v->type == VEH_TRAIN && IsTrainWagon(v)) continue;
-				if (v->type == VEH_AIRCRAFT && v->subtype != AIR_HELICOPTER) continue;
-				if (v->type == VEH_ROAD && !IsRoadVehFront(v)) continue;
+				RunVehicleSounds(v);
+				break;
 
-				v->motion_counter += (v->direction & 1) ? (v->cur_speed * 3) / 4 : v->cur_speed;
-				/* Play a running sound if the motion counter passes 256 (Do we not skip sounds?) */
-				if (GB(v->motion_counter, 0, 8) < v->cur_speed) PlayVehicleSound(v, VSE_RUNNING);
+			case VEH_AIRCRAFT:
+				if (v->subtype == AIR_HELICOPTER) RunVehicleSounds(v);
+				break;
+		}
 
-				/* Play an alterate running sound every 16 ticks */
-				if (GB(v->tick_counter, 0, 4) == 0) PlayVehicleSound(v, v->cur_speed > 0 ? VSE_RUNNING_16 : VSE_STOPPED_16);
+		if (CanVehicleSleep(v)) {
+			v->dormant = true;
+			GetVehicleTickProgress(v, &v->dormant_ticks, &v->dormant_cargo_ages);
+			UpdateVehicleTickList(v);
 		}
 	}
 
+	/* The searches of ships that did not move as expected are of no use anymore */
+	YapfClearShipSearches();
+
+	_vehicle_tick_index = INVALID_VEHICLE;
+	_vehicle_tick_count++;
+	if (_age_cargo_skip_counter == 0) _vehicle_cargo_age_count++;
+
 	/* now we handle all the vehicles that entered a depot this tick */
-	v = _first_veh_in_depot_list;
+	Vehicle *v = _first_veh_in_depot_list;
 	while (v != NULL) {
 		Vehicle *w = v->depot_list;
 		v->depot_list = NULL; // it should always be NULL at the end of each tick
@@ -851,29 +1296,14 @@ void ViewportAddVehicles(DrawPixelInfo *dpi)
 	const int b = dpi->top + dpi->height;
 
 	/* The hash area to scan */
-	int xl, xu, yl, yu;
-
-	if (dpi->width + 70 < (1 << (7 + 6))) {
-		xl = GB(l - 70, 7, 6);
-		xu = GB(r,      7, 6);
-	} else {
-		/* scan whole hash row */
-		xl = 0;
-		xu = 0x3F;
-	}
-
-	if (dpi->height + 70 < (1 << (6 + 6))) {
-		yl = GB(t - 70, 6, 6) << 6;
-		yu = GB(b,      6, 6) << 6;
-	} else {
-		/* scan whole column */
-		yl = 0;
-		yu = 0x3F << 6;
-	}
+	uint xl = GetViewportHashX(l - VIEWPORT_HASH_MARGIN);
+	uint xu = GetViewportHashX(r);
+	uint yl = GetViewportHashY(t - VIEWPORT_HASH_MARGIN);
+	uint yu = GetViewportHashY(b);
 
-	for (int y = yl;; y = (y + (1 << 6)) & (0x3F << 6)) {
-		for (int x = xl;; x = (x + 1) & 0x3F) {
-			const Vehicle *v = _vehicle_position_hash[x + y]; // already masked & 0xFFF
+	for (uint y = yl; y <= yu; y++) {
+		for (uint x = xl; x <= xu; x++) {
+			const Vehicle *v = _vehicle_position_hash[y * _viewport_hash_size_x + x];
 
 			while (v != NULL) {
 				if (!(v->vehstatus & VS_HIDDEN) &&
@@ -885,11 +1315,7 @@ void ViewportAddVehicles(DrawPixelInfo *dpi)
 				}
 				v = v->next_hash;
 			}
-
-			if (x == xu) break;
 		}
-
-		if (y == yu) break;
 	}
 }
 
@@ -2970,6 +3396,15 @@ static const SaveLoad _train_desc[] = {
 	SLE_CONDVARX(cpp_offsetof(Vehicle, u) + cpp_offsetof(VehicleRail, flags),                  SLE_UINT8,  2, SL_MAX_VERSION),
 	SLE_CONDNULL(2, 2, 59),
 
+	SLE_CONDVARX(cpp_offsetof(Vehicle, u) + cpp_offsetof(VehicleRail, route.dest_tile),        SLE_UINT32, 94, SL_MAX_VERSION),
+	SLE_CONDARRX(cpp_offsetof(Vehicle, u) + cpp_offsetof(VehicleRail, route.decisions),        SLE_UINT32, RAIL_ROUTE_CACHE_SIZE, 94, SL_MAX_VERSION),
+	SLE_CONDVARX(cpp_offsetof(Vehicle, u) + cpp_offsetof(VehicleRail, route.length),           SLE_UINT8,  94, SL_MAX_VERSION),
+	SLE_CONDVARX(cpp_offsetof(Vehicle, u) + cpp_offsetof(VehicleRail, route.pos),              SLE_UINT8,  94, SL_MAX_VERSION),
+	SLE_CONDVARX(cpp_offsetof(Vehicle, u) + cpp_offsetof(VehicleRail, route.min_x),            SLE_UINT16, 94, SL_MAX_VERSION),
+	SLE_CONDVARX(cpp_offsetof(Vehicle, u) + cpp_offsetof(VehicleRail, route.min_y),            SLE_UINT16, 94, SL_MAX_VERSION),
+	SLE_CONDVARX(cpp_offsetof(Vehicle, u) + cpp_offsetof(VehicleRail, route.max_x),            SLE_UINT16, 94, SL_MAX_VERSION),
+	SLE_CONDVARX(cpp_offsetof(Vehicle, u) + cpp_offsetof(VehicleRail, route.max_y),            SLE_UINT16, 94, SL_MAX_VERSION),
+
 	SLE_CONDNULL(2, 2, 19),
 	/* reserve extra space in savegame here. (currently 11 bytes) */
 	SLE_CONDNULL(11, 2, SL_MAX_VERSION),
@@ -3113,6 +3548,9 @@ static const SaveLoad *_veh_descs[] = {
 static void Save_VEHS()
 {
 	Vehicle *v;
+	/* The saved counters of dormant vehicles have to be up to date */
+	CatchUpDormantVehicles();
+
 	/* Write the vehicles */
 	FOR_ALL_VEHICLES(v) {
 		SlSetArrayIndex(v->index);
@@ -3276,12 +3714,17 @@ void Vehicle::HandleLoading(bool mode)
 
 void Vehicle::SetNext(Vehicle *next)
 {
+	/* Both chains change, so their dormant parts must be up to date */
+	WakeVehicle(this);
+	if (next != NULL) WakeVehicle(next);
+
 	if (this->next != NULL) {
 		/* We had an old next vehicle. Update the first and previous pointers */
 		for (Vehicle *v = this->next; v != NULL; v = v->Next()) {
 			v->first = this->next;
 		}
 		this->next->previous = NULL;
+		UpdateVehicleTickList(this->next);
 	}
 
 	this->next = next;
@@ -3293,6 +3736,7 @@ void Vehicle::SetNext(Vehicle *next)
 		for (Vehicle *v = this->next; v != NULL; v = v->Next()) {
 			v->first = this->first;
 		}
+		UpdateVehicleTickList(this->next);
 	}
 }
 
@@ -75,6 +75,20 @@ enum VehicleFlags {
 	VF_AUTOFILL_TIMETABLE, ///< Whether the vehicle should fill in the timetable automatically.
 };
 
+/** Number of junctions ahead a train remembers the way through. */
+static const uint RAIL_ROUTE_CACHE_SIZE = 8;
+
+/** The way through the next junctions of a train, kept from its last path search. */
+struct RailRouteCache {
+	TileIndex dest_tile;                     ///< destination of the train when the route was searched
+	uint32 decisions[RAIL_ROUTE_CACHE_SIZE]; ///< junction tile << 4 | trackdir to take there, in the order the train gets there
+	byte length;                             ///< number of decisions on the route, 0 when the train has no route
+	byte pos;                                ///< the next decision to take
+	uint16 min_x, min_y;                     ///< north corner of the tiles the route passes
+	uint16 max_x, max_y;                     ///< south corner of the tiles the route passes
+	bool listed;                             ///< NOSAVE: whether the train is in the list of trains with a route
+};
+
 struct VehicleRail {
 	uint16 last_speed; // NOSAVE: only used in UI
 	uint16 crash_anim_pos;
@@ -116,6 +130,9 @@ struct VehicleRail {
 
 	/* Cached wagon override spritegroup */
 	const struct SpriteGroup *cached_override;
+
+	/* The way through the next junctions, only used for the first engine */
+	RailRouteCache route;
 };
 
 enum VehicleRailFlags {
@@ -183,6 +200,12 @@ struct VehicleShip {
 
 DECLARE_OLD_POOL(Vehicle, Vehicle, 9, 125)
 
+struct Vehicle;
+void UpdateVehicleTickList(const Vehicle *v);
+void WakeVehicle(Vehicle *v);
+void CatchUpDormantVehicles();
+byte GetVehicleTickCounter(const Vehicle *v);
+
 /* Some declarations of functions, so we can make them friendly */
 struct SaveLoad;
 extern const SaveLoad *GetVehicleDescription(VehicleType vt);
@@ -191,7 +214,18 @@ struct LoadgameState;
 extern bool LoadOldVehicle(LoadgameState *ls, int num);
 
 struct Vehicle : PoolItem<Vehicle, VehicleID, &_Vehicle_pool>, BaseVehicle {
+	/* The members that are used every tick by a moving vehicle come first,
+	 * up to and including the union, so ticking a vehicle touches as few
+	 * cache lines as possible. Members only used by the GUI, the daily and
+	 * yearly loops or the order handling go after the union. */
 	byte subtype;            // subtype (Filled with values from EffectVehicles/TrainSubTypes/AircraftSubTypes)
+	byte vehstatus;          // Status
+	DirectionByte direction; // facing
+	byte progress;
+	byte subspeed;           // fractional speed
+	byte acceleration;       // used by train & aircraft
+	byte tick_counter;       ///< Increased by one for each tick
+	byte running_ticks;      ///< Number of ticks this vehicle was not stopped this day
 
 private:
 	Vehicle *next;           // pointer to the next vehicle in the chain
@@ -202,20 +236,18 @@ public:
 	friend void AfterLoadVehicles(bool clear_te_id);              // So we can set the previous and first pointers while loading
 	friend bool LoadOldVehicle(LoadgameState *ls, int num);       // So we can set the proper next pointer while loading
 
-	Vehicle *depot_list;     // NOSAVE: linked list to tell what vehicles entered a depot during the last tick. Used by autoreplace
-
-	char *name;              ///< Name of vehicle
-
-	UnitID unitnumber;       // unit number, for display purposes only
-	PlayerByte owner;        // which player owns the vehicle?
-
 	TileIndex tile;          // Current tile index
-	TileIndex dest_tile;     // Heading for this tile
 
 	int32 x_pos;             // coordinates
 	int32 y_pos;
 	byte z_pos;
-	DirectionByte direction; // facing
+
+	byte breakdown_ctr;
+	uint16 max_speed;        // maximum speed
+	uint16 cur_speed;        // current speed
+	uint16 load_unload_time_rem;
+	uint32 motion_counter;
+	uint32 current_order_time;     ///< How many ticks have passed since this order started.
 
 	byte spritenum;          // currently displayed sprite index
 	                         // 0xfd == custom sprite, 0xfe == custom second head sprite
@@ -228,6 +260,36 @@ public:
 	int8 y_offs;             // y offset for vehicle sprite
 	EngineID engine_type;
 
+	Order current_order;     ///< The current order (+ status, like: loading)
+
+	/* Boundaries for the current position in the world and a next hash link.
+	 * NOSAVE: All of those can be updated with VehiclePositionChanged() */
+	int32 left_coord;
+	int32 top_coord;
+	int32 right_coord;
+	int32 bottom_coord;
+	Vehicle *next_hash;
+	Vehicle *next_new_hash;
+	Vehicle **old_new_hash;
+
+	union {
+		VehicleRail rail;
+		VehicleAir air;
+		VehicleRoad road;
+		VehicleSpecial special;
+		VehicleDisaster disaster;
+		VehicleShip ship;
+	} u;
+
+	Vehicle *depot_list;     // NOSAVE: linked list to tell what vehicles entered a depot during the last tick. Used by autoreplace
+
+	char *name;              ///< Name of vehicle
+
+	UnitID unitnumber;       // unit number, for display purposes only
+	PlayerByte owner;        // which player owns the vehicle?
+
+	TileIndex dest_tile;     // Heading for this tile
+
 	TextEffectID fill_percent_te_id; // a text-effect id to a loading indicator object
 
 	/* for randomized variational spritegroups
@@ -236,14 +298,6 @@ public:
 	byte random_bits;
 	byte waiting_triggers;   // triggers to be yet matched
 
-	uint16 max_speed;        // maximum speed
-	uint16 cur_speed;        // current speed
-	byte subspeed;           // fractional speed
-	byte acceleration;       // used by train & aircraft
-	byte progress;
-	uint32 motion_counter;
-
-	byte vehstatus;          // Status
 	StationID last_station_visited;
 
 	CargoID cargo_type;      // type of cargo this vehicle is carrying
@@ -253,11 +307,8 @@ public:
 
 
 	byte day_counter;        ///< Increased by one for each day
-	byte tick_counter;       ///< Increased by one for each tick
-	byte running_ticks;      ///< Number of ticks this vehicle was not stopped this day
 
 	/* Begin Order-stuff */
-	Order current_order;     ///< The current order (+ status, like: loading)
 	VehicleOrderID cur_order_index; ///< The index to the current order
 
 	Order *orders;           ///< Pointer to the first order for this vehicle
@@ -267,16 +318,6 @@ public:
 	Vehicle *prev_shared;    ///< If not NULL, this points to the prev vehicle that shared the order
 	/* End Order-stuff */
 
-	/* Boundaries for the current position in the world and a next hash link.
-	 * NOSAVE: All of those can be updated with VehiclePositionChanged() */
-	int32 left_coord;
-	int32 top_coord;
-	int32 right_coord;
-	int32 bottom_coord;
-	Vehicle *next_hash;
-	Vehicle *next_new_hash;
-	Vehicle **old_new_hash;
-
 	/* Related to age and service time */
 	Date age;     // Age in days
 	Date max_age; // Maximum age
@@ -284,7 +325,6 @@ public:
 	Date service_interval;
 	uint16 reliability;
 	uint16 reliability_spd_dec;
-	byte breakdown_ctr;
 	byte breakdown_delay;
 	byte breakdowns_since_last_service;
 	byte breakdown_chance;
@@ -292,7 +332,6 @@ public:
 
 	bool leave_depot_instantly; // NOSAVE: stores if the vehicle needs to leave the depot it just entered. Used by autoreplace
 
-	uint16 load_unload_time_rem;
 	byte vehicle_flags;         // Used for gradual loading and other miscellaneous things (@see VehicleFlags enum)
 
 	Money profit_this_year;        ///< Profit this year << 8, low 8 bits are fract
@@ -302,20 +341,13 @@ public:
 	GroupID group_id;              ///< Index of group Pool array
 
 	/* Used for timetabling. */
-	uint32 current_order_time;     ///< How many ticks have passed since this order started.
 	int32 lateness_counter;        ///< How many ticks late (or early if negative) this vehicle is.
 
 	SpriteID colormap; // NOSAVE: cached color mapping
 
-	union {
-		VehicleRail rail;
-		VehicleAir air;
-		VehicleRoad road;
-		VehicleSpecial special;
-		VehicleDisaster disaster;
-		VehicleShip ship;
-	} u;
-
+	bool dormant;                  ///< NOSAVE: Parked vehicle that is not ticked, see WakeVehicle
+	uint32 dormant_ticks;          ///< NOSAVE: Vehicle ticks that had passed when the vehicle became dormant
+	uint32 dormant_cargo_ages;     ///< NOSAVE: Cargo agings that had passed when the vehicle became dormant
 
 	/**
 	 * Allocates a lot of vehicles.
@@ -539,7 +571,7 @@ public:
  */
 struct SpecialVehicle : public Vehicle {
 	/** Initializes the Vehicle to a special vehicle */
-	SpecialVehicle() { this->type = VEH_SPECIAL; }
+	SpecialVehicle() { this->type = VEH_SPECIAL; UpdateVehicleTickList(this); }
 
 	/** We want to 'destruct' the right class. */
 	virtual ~SpecialVehicle() {}
@@ -559,7 +591,7 @@ struct SpecialVehicle : public Vehicle {
  */
 struct DisasterVehicle : public Vehicle {
 	/** Initializes the Vehicle to a disaster vehicle */
-	DisasterVehicle() { this->type = VEH_DISASTER; }
+	DisasterVehicle() { this->type = VEH_DISASTER; UpdateVehicleTickList(this); }
 
 	/** We want to 'destruct' the right class. */
 	virtual ~DisasterVehicle() {}
@@ -579,7 +611,7 @@ struct DisasterVehicle : public Vehicle {
  */
 struct InvalidVehicle : public Vehicle {
 	/** Initializes the Vehicle to a invalid vehicle */
-	InvalidVehicle() { this->type = VEH_INVALID; }
+	InvalidVehicle() { this->type = VEH_INVALID; UpdateVehicleTickList(this); }
 
 	/** We want to 'destruct' the right class. */
 	virtual ~InvalidVehicle() {}
@@ -606,7 +638,7 @@ static inline uint GetNumVehicles()
 	return GetVehiclePoolSize();
 }
 
-#define FOR_ALL_VEHICLES_FROM(v, start) for (v = GetVehicle(start); v != NULL; v = (v->index + 1U < GetVehiclePoolSize()) ? GetVehicle(v->index + 1) : NULL) if (v->IsValid())
+#define FOR_ALL_VEHICLES_FROM(v, start) for (v = _Vehicle_pool.GetNextLive(start); v != NULL; v = _Vehicle_pool.GetNextLive(v->index + 1U)) if (v->IsValid())
 #define FOR_ALL_VEHICLES(v) FOR_ALL_VEHICLES_FROM(v, 0)
 
 /**
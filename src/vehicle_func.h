@@ -35,6 +35,10 @@ uint8 CalcPercentVehicleFilled(Vehicle *v, StringID *color);
 void InitializeTrains();
 byte VehicleRandomBits();
 void ResetVehiclePosHash();
+void GetVehiclePosHashStats(VehicleHashStats *stats);
+void GetVehiclePosHashMemoryUsage(struct MemoryUsage *usage);
+void GetViewportVehicleHashStats(VehicleHashStats *stats);
+void GetViewportVehicleHashMemoryUsage(struct MemoryUsage *usage);
 void ResetVehicleColorMap();
 
 bool CanRefitTo(EngineID engine_type, CargoID cid_to);
@@ -60,4 +60,14 @@ enum {
 	VPF_YAPF = 2, ///< Yet Another PathFinder
 };
 
+/** Statistics about the chains of a hash of vehicles. */
+struct VehicleHashStats {
+	uint size_x;    ///< Number of buckets along the X axis
+	uint size_y;    ///< Number of buckets along the Y axis
+	uint vehicles;  ///< Number of vehicles in the hash
+	uint used;      ///< Number of buckets with at least one vehicle
+	uint longest;   ///< Length of the longest chain
+	uint64 squares; ///< Sum of the squared lengths of all chains
+};
+
 #endif /* VEHICLE_TYPE_H */
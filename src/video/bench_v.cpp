@@ -0,0 +1,162 @@
+/* $Id$ */
+
+/** @file bench_v.cpp Video driver that benchmarks the game loop of a savegame. */
+
+#include "../stdafx.h"
+#include "../openttd.h"
+#include "../gfx_func.h"
+#include "../variables.h"
+#include "../debug.h"
+#include "../profiler.h"
+#include "../meminfo.h"
+#include "../fios.h"
+#include "../string_func.h"
+#include "../map_func.h"
+#include "../saveload.h"
+#include "../core/alloc_func.hpp"
+#include "../blitter/factory.hpp"
+#include "bench_v.h"
+
+#include "../safeguards.h"
+
+extern void StateGameLoop();
+extern void SwitchMode(int new_mode);
+
+static FVideoDriver_Bench iFVideoDriver_Bench;
+
+/** Upper limit of the ticks parameter; keeps the sample buffer and the percentile index within 32 bits. */
+static const int MAX_BENCH_TICKS = 1000000;
+
+const char *VideoDriver_Bench::Start(const char * const *parm)
+{
+	int ticks = GetDriverParamInt(parm, "ticks", 1000);
+	if (ticks < 1) return "the number of ticks must be at least 1";
+	if (ticks > MAX_BENCH_TICKS) return "the number of ticks must be at most 1000000";
+	this->ticks = ticks;
+	this->file[0] = '\0';
+	this->save[0] = '\0';
+	/* The parameter strings do not outlive this call, so copy the file names */
+	if (parm != NULL) {
+		for (; *parm != NULL; parm++) {
+			if (strncmp(*parm, "file=", 5) == 0) strecpy(this->file, *parm + 5, lastof(this->file));
+			if (strncmp(*parm, "save=", 5) == 0) strecpy(this->save, *parm + 5, lastof(this->save));
+		}
+	}
+
+	_screen.width = _screen.pitch = _cur_resolution[0];
+	_screen.height = _cur_resolution[1];
+	/* Do not render, nor blit */
+	DEBUG(misc, 1, "Forcing blitter 'null'...");
+	BlitterFactoryBase::SelectBlitter("null");
+	return NULL;
+}
+
+void VideoDriver_Bench::Stop() { }
+
+void VideoDriver_Bench::MakeDirty(int left, int top, int width, int height) {}
+
+static int CDECL CompareTimes(const void *a, const void *b)
+{
+	uint32 ta = *(const uint32*)a;
+	uint32 tb = *(const uint32*)b;
+	return (ta > tb) - (ta < tb);
+}
+
+void VideoDriver_Bench::MainLoop()
+{
+	if (_switch_mode != SM_LOAD_GAME) {
+		DEBUG(driver, 0, "The bench video driver needs a savegame; pass one with -g");
+		return;
+	}
+
+	_switch_mode = SM_NONE;
+	SwitchMode(SM_LOAD_GAME);
+	if (_game_mode != GM_NORMAL) {
+		DEBUG(driver, 0, "Loading '%s' failed, aborting benchmark", _file_to_saveload.name);
+		return;
+	}
+
+	/* A paused game would only measure the pause handling */
+	_pause_game = 0;
+
+	/* The samples are stored per phase, so each phase can be sorted on its own */
+	uint32 *samples = MallocT<uint32>(this->ticks * GLP_END);
+
+	uint64 start = GetTimeMicroseconds();
+	for (uint i = 0; i < this->ticks; i++) {
+		StateGameLoop();
+		for (uint p = 0; p < GLP_END; p++) {
+			samples[p * this->ticks + i] = _game_loop_phase_time[p];
+		}
+	}
+	uint64 wall_time = GetTimeMicroseconds() - start;
+
+	/* Saving is timed including compression and writing the file */
+	uint64 save_time = 0;
+	if (!StrEmpty(this->save)) {
+		start = GetTimeMicroseconds();
+		if (SaveOrLoad(this->save, SL_SAVE, NO_DIRECTORY) != SL_OK) {
+			DEBUG(driver, 0, "Saving '%s' failed", this->save);
+		}
+		WaitTillSaved();
+		save_time = GetTimeMicroseconds() - start;
+	}
+
+	FILE *f = stdout;
+	if (!StrEmpty(this->file)) {
+		f = fopen(this->file, "w");
+		if (f == NULL) {
+			DEBUG(driver, 0, "Could not open '%s' for writing, using stdout", this->file);
+			f = stdout;
+		}
+	}
+
+	/* Tick times only compare between savegames together with the map they ran on */
+	fprintf(f, "map_size=%ux%u\n", MapSizeX(), MapSizeY());
+	fprintf(f, "map_bytes=%u\n", (uint)GetMapMemoryUsage(MapSize()));
+	fprintf(f, "map_bytes_per_tile=%u\n", (uint)GetMapMemoryUsage(1));
+#ifdef MAP_PLANES
+	fprintf(f, "map_layout=planes\n");
+#else
+	fprintf(f, "map_layout=tiles\n");
+#endif /* MAP_PLANES */
+#ifdef MAP_BLOCKS
+	fprintf(f, "map_blocks=%u\n", 1 << MAP_BLOCK_BITS);
+#else
+	fprintf(f, "map_blocks=0\n");
+#endif /* MAP_BLOCKS */
+	fprintf(f, "ticks=%u\n", this->ticks);
+	fprintf(f, "wall_time_us=%" OTTD_PRINTF64 "u\n", wall_time);
+	fprintf(f, "ticks_per_second=%.2f\n", wall_time == 0 ? 0.0 : this->ticks * 1000000.0 / wall_time);
+	if (!StrEmpty(this->save)) fprintf(f, "save_us=%" OTTD_PRINTF64 "u\n", save_time);
+
+	MemoryUsage usage[MAX_MEMORY_USAGE];
+	uint parts = GetMemoryUsage(usage, lengthof(usage));
+	for (uint i = 0; i < parts; i++) {
+		fprintf(f, "mem.%s.allocated=%" OTTD_PRINTF64 "u\n", usage[i].name, usage[i].allocated);
+		fprintf(f, "mem.%s.used=%" OTTD_PRINTF64 "u\n", usage[i].name, usage[i].used);
+		fprintf(f, "mem.%s.items=%u\n", usage[i].name, usage[i].items);
+		fprintf(f, "mem.%s.peak=%u\n", usage[i].name, usage[i].peak);
+	}
+
+	for (uint p = 0; p < GLP_END; p++) {
+		uint32 *phase = samples + p * this->ticks;
+		uint64 total = 0;
+		for (uint i = 0; i < this->ticks; i++) total += phase[i];
+
+		qsort(phase, this->ticks, sizeof(*phase), CompareTimes);
+
+		const char *name = GetGameLoopPhaseName((GameLoopPhase)p);
+		fprintf(f, "%s.min_us=%u\n", name, phase[0]);
+		fprintf(f, "%s.median_us=%u\n", name, phase[this->ticks / 2]);
+		fprintf(f, "%s.p99_us=%u\n", name, phase[min(this->ticks - 1, this->ticks * 99 / 100)]);
+		fprintf(f, "%s.total_us=%" OTTD_PRINTF64 "u\n", name, total);
+	}
+
+	if (f != stdout) fclose(f);
+	free(samples);
+}
+
+bool VideoDriver_Bench::ChangeResolution(int w, int h) { return false; }
+
+bool VideoDriver_Bench::ToggleFullscreen(bool fs) { return false; }
@@ -0,0 +1,39 @@
+/* $Id$ */
+
+/** @file bench_v.h Video driver that benchmarks the game loop of a savegame. */
+
+#ifndef VIDEO_BENCH_H
+#define VIDEO_BENCH_H
+
+#include "video_driver.hpp"
+
+class VideoDriver_Bench: public VideoDriver {
+private:
+	uint ticks;          ///< Number of ticks to run the benchmark for.
+	char file[MAX_PATH]; ///< File to write the results to, or empty for stdout.
+	char save[MAX_PATH]; ///< Savegame to write after the run to time saving, or empty to skip that.
+
+public:
+	/* virtual */ const char *Start(const char * const *param);
+
+	/* virtual */ void Stop();
+
+	/* virtual */ void MakeDirty(int left, int top, int width, int height);
+
+	/* virtual */ void MainLoop();
+
+	/* virtual */ bool ChangeResolution(int w, int h);
+
+	/* virtual */ bool ToggleFullscreen(bool fullscreen);
+};
+
+class FVideoDriver_Bench: public VideoDriverFactory<FVideoDriver_Bench> {
+public:
+	/* Lower than the null driver, so probing never ends up selecting it */
+	static const int priority = 0;
+	/* virtual */ const char *GetName() { return "bench"; }
+	/* virtual */ const char *GetDescription() { return "Benchmark Video Driver (param ticks,file,save)"; }
+	/* virtual */ Driver *CreateInstance() { return new VideoDriver_Bench(); }
+};
+
+#endif /* VIDEO_BENCH_H */
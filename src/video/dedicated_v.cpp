@@ -18,6 +18,8 @@
 #include "../core/alloc_func.hpp"
 #include "../player_func.h"
 #include "../core/random_func.hpp"
+#include "../core/math_func.hpp"
+#include "../profiler.h"
 #include "dedicated_v.h"
 
 #ifdef BEOS_NET_SERVER
@@ -128,6 +130,11 @@ static void CloseWindowsConsoleThread()
 
 static void *_dedicated_video_mem;
 
+enum {
+	DEDICATED_TICK_INTERVAL = 30, ///< Milliseconds between two game ticks.
+	DEDICATED_MAX_CATCH_UP  = 10, ///< Maximum number of ticks run back-to-back before missed ticks are dropped.
+};
+
 extern bool SafeSaveOrLoad(const char *filename, int mode, int newgm, Subdirectory subdir);
 extern void SwitchMode(int new_mode);
 
@@ -199,6 +206,29 @@ static uint32 GetTime()
 	return tim.tv_usec / 1000 + tim.tv_sec * 1000;
 }
 
+/** Whether standard input is closed, so there is no console input to wait for. */
+static bool _stdin_closed = false;
+
+/**
+ * Sleep until there is console input, the network received something, or
+ * the given time has passed. Network data is handled immediately.
+ * @param timeout the maximum time to wait in milliseconds
+ */
+static void DedicatedWaitForEvents(uint32 timeout)
+{
+	struct timeval tv;
+	fd_set readfds;
+
+	tv.tv_sec = timeout / 1000;
+	tv.tv_usec = (timeout % 1000) * 1000;
+
+	FD_ZERO(&readfds);
+	if (!_dedicated_forks && !_stdin_closed) FD_SET(STDIN, &readfds);
+	NetworkAddSocketsToSet(&readfds);
+
+	if (select(FD_SETSIZE, &readfds, NULL, NULL, &tv) > 0) NetworkHandleIncoming();
+}
+
 #else
 
 static bool InputWaiting()
@@ -211,18 +241,47 @@ static uint32 GetTime()
 	return GetTickCount();
 }
 
+/**
+ * Sleep until the network received something or the given time has passed.
+ * Network data is handled immediately. Console input arrives via an event
+ * that can not be waited on together with the sockets, so never wait long.
+ * @param timeout the maximum time to wait in milliseconds
+ */
+static void DedicatedWaitForEvents(uint32 timeout)
+{
+	struct timeval tv;
+	fd_set readfds;
+
+	timeout = min(timeout, 10U);
+	tv.tv_sec = 0;
+	tv.tv_usec = timeout * 1000;
+
+	FD_ZERO(&readfds);
+	if (!NetworkAddSocketsToSet(&readfds)) {
+		/* Winsock refuses to select on an empty set */
+		CSleep(timeout);
+		return;
+	}
+
+	if (select(FD_SETSIZE, &readfds, NULL, NULL, &tv) > 0) NetworkHandleIncoming();
+}
+
 #endif
 
 static void DedicatedHandleKeyInput()
 {
 	static char input_line[200] = "";
 
-	if (!InputWaiting()) return;
+	if (_stdin_closed || !InputWaiting()) return;
 
 	if (_exit_game) return;
 
 #if defined(UNIX) || defined(__OS2__) || defined(PSP)
-	if (fgets(input_line, lengthof(input_line), stdin) == NULL) return;
+	if (fgets(input_line, lengthof(input_line), stdin) == NULL) {
+		/* Nothing will ever be read anymore, so stop waiting for it */
+		if (feof(stdin)) _stdin_closed = true;
+		return;
+	}
 #else
 	/* Handle console input, and singal console thread, it can accept input again */
 	assert_compile(lengthof(_win_console_thread_buffer) <= lengthof(input_line));
@@ -246,8 +305,6 @@ static void DedicatedHandleKeyInput()
 
 void VideoDriver_Dedicated::MainLoop()
 {
-	uint32 cur_ticks = GetTime();
-	uint32 next_tick = cur_ticks + 30;
 
 	/* Signal handlers */
 #if defined(UNIX) || defined(PSP)
@@ -288,22 +345,54 @@ void VideoDriver_Dedicated::MainLoop()
 		return;
 	}
 
+	uint32 next_tick = GetTime() + DEDICATED_TICK_INTERVAL;
+
 	while (!_exit_game) {
-		uint32 prev_cur_ticks = cur_ticks; // to check for wrapping
 		InteractiveRandom(); // randomness
 
 		if (!_dedicated_forks)
 			DedicatedHandleKeyInput();
 
-		cur_ticks = GetTime();
-		if (cur_ticks >= next_tick || cur_ticks < prev_cur_ticks) {
-			next_tick = cur_ticks + 30;
+		if (_fast_forward && _network_game_info.clients_on != 0) {
+			/* Clients can't keep up with an unthrottled server */
+			_fast_forward = 0;
+			IConsolePrint(_icolour_warn, "A client joined; fast forward has been switched off.");
+		}
 
+		if (_fast_forward && !_pause_game) {
+			/* Run as fast as possible; there are no clients to keep up with */
 			GameLoop();
-			_screen.dst_ptr = _dedicated_video_mem;
-			UpdateWindows();
+			ReportFastForwardProgress();
+			next_tick = GetTime() + DEDICATED_TICK_INTERVAL;
+			continue;
 		}
-		CSleep(1);
+
+		/* The difference is computed signed, so wrapping of the timer does not matter */
+		int32 delay = GetTime() - next_tick;
+		if (delay < 0) {
+			DedicatedWaitForEvents(-delay);
+			continue;
+		}
+
+		if (delay >= DEDICATED_MAX_CATCH_UP * DEDICATED_TICK_INTERVAL) {
+			/* Too far behind to catch up; skip the missed ticks instead
+			 * of not reacting to anything while running all of them. */
+			uint32 dropped = delay / DEDICATED_TICK_INTERVAL;
+			_tick_schedule_stats.dropped += dropped;
+			next_tick += dropped * DEDICATED_TICK_INTERVAL;
+		}
+
+		_tick_schedule_stats.ticks++;
+		if (delay >= DEDICATED_TICK_INTERVAL) _tick_schedule_stats.overruns++;
+		_tick_schedule_stats.worst_delay = max(_tick_schedule_stats.worst_delay, (uint32)delay);
+
+		/* Schedule from the deadline instead of from now, so missed
+		 * ticks are run back-to-back until the game caught up again. */
+		next_tick += DEDICATED_TICK_INTERVAL;
+
+		GameLoop();
+		_screen.dst_ptr = _dedicated_video_mem;
+		UpdateWindows();
 	}
 }
 
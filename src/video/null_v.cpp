@@ -5,6 +5,7 @@
 #include "../gfx_func.h"
 #include "../variables.h"
 #include "../debug.h"
+#include "../profiler.h"
 #include "../blitter/factory.hpp"
 #include "null_v.h"
 
@@ -31,10 +32,10 @@ void VideoDriver_Null::MainLoop()
 {
 	uint i;
 
+	/* Nothing is ever shown, so there is no need to update the windows */
 	for (i = 0; i < this->ticks; i++) {
 		GameLoop();
-		_screen.dst_ptr = NULL;
-		UpdateWindows();
+		if (_fast_forward && !_pause_game) ReportFastForwardProgress();
 	}
 }
 
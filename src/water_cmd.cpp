@@ -35,6 +35,7 @@
 #include "clear_map.h"
 #include "tree_map.h"
 #include "aircraft.h"
+#include "yapf/yapf.h"
 
 #include "table/sprites.h"
 #include "table/strings.h"
@@ -208,6 +209,8 @@ CommandCost CmdBuildShipDepot(TileIndex tile, uint32 flags, uint32 p1, uint32 p2
 		MakeShipDepot(tile2, _current_player, DEPOT_SOUTH, axis, wc2);
 		MarkTileDirtyByTile(tile);
 		MarkTileDirtyByTile(tile2);
+		YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
+		YapfNotifyTrackLayoutChange(tile2, INVALID_TRACK);
 	}
 
 	return CommandCost(EXPENSES_CONSTRUCTION, _price.build_ship_depot);
@@ -244,6 +247,8 @@ static CommandCost RemoveShipDepot(TileIndex tile, uint32 flags)
 		MakeWaterKeepingClass(tile2, GetTileOwner(tile2));
 		MarkTileDirtyByTile(tile);
 		MarkTileDirtyByTile(tile2);
+		YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
+		YapfNotifyTrackLayoutChange(tile2, INVALID_TRACK);
 	}
 
 	return CommandCost(EXPENSES_CONSTRUCTION, _price.remove_ship_depot);
@@ -291,6 +296,9 @@ static CommandCost DoBuildShiplift(TileIndex tile, DiagDirection dir, uint32 fla
 		MarkTileDirtyByTile(tile + delta);
 		MarkCanalsAndRiversAroundDirty(tile - delta);
 		MarkCanalsAndRiversAroundDirty(tile + delta);
+		YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
+		YapfNotifyTrackLayoutChange(tile - delta, INVALID_TRACK);
+		YapfNotifyTrackLayoutChange(tile + delta, INVALID_TRACK);
 	}
 
 	return CommandCost(EXPENSES_CONSTRUCTION, _price.clear_water * 22 >> 3);
@@ -314,6 +322,9 @@ static CommandCost RemoveShiplift(TileIndex tile, uint32 flags)
 		MarkTileDirtyByTile(tile + delta);
 		MarkCanalsAndRiversAroundDirty(tile - delta);
 		MarkCanalsAndRiversAroundDirty(tile + delta);
+		YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
+		YapfNotifyTrackLayoutChange(tile - delta, INVALID_TRACK);
+		YapfNotifyTrackLayoutChange(tile + delta, INVALID_TRACK);
 	}
 
 	return CommandCost(EXPENSES_CONSTRUCTION, _price.clear_water * 2);
@@ -393,6 +404,7 @@ CommandCost CmdBuildCanal(TileIndex tile, uint32 flags, uint32 p1, uint32 p2)
 			}
 			MarkTileDirtyByTile(tile);
 			MarkCanalsAndRiversAroundDirty(tile);
+			YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 		}
 
 		cost.AddCost(_price.clear_water);
@@ -425,6 +437,7 @@ static CommandCost ClearTile_Water(TileIndex tile, byte flags)
 			if (flags & DC_EXEC) {
 				DoClearSquare(tile);
 				MarkCanalsAndRiversAroundDirty(tile);
+				YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 			}
 			return CommandCost(EXPENSES_CONSTRUCTION, _price.clear_water);
 
@@ -437,6 +450,7 @@ static CommandCost ClearTile_Water(TileIndex tile, byte flags)
 			if (flags & DC_EXEC) {
 				DoClearSquare(tile);
 				MarkCanalsAndRiversAroundDirty(tile);
+				YapfNotifyTrackLayoutChange(tile, INVALID_TRACK);
 			}
 			if (IsSlopeWithOneCornerRaised(slope)) {
 				return CommandCost(EXPENSES_CONSTRUCTION, _price.clear_water);
@@ -828,6 +842,7 @@ static void FloodVehicle(Vehicle *v)
 
 			if (v->type != VEH_AIRCRAFT) v = v->First();
 			u = v;
+			WakeVehicle(v);
 
 			/* crash all wagons, and count passengers */
 			BEGIN_ENUM_WAGONS(v)
@@ -942,6 +957,8 @@ static void DoFloodTile(TileIndex target)
 
 			case MP_TREES:
 				if (!IsSlopeWithOneCornerRaised(tileh)) {
+					/* Already flooded; nothing changes */
+					if (GetTreeGround(target) == TREE_GROUND_SHORE) break;
 					SetTreeGroundDensity(target, TREE_GROUND_SHORE, 3);
 					MarkTileDirtyByTile(target);
 					flooded = true;
@@ -975,6 +992,9 @@ static void DoFloodTile(TileIndex target)
 		/* Mark surrounding canal tiles dirty too to avoid glitches */
 		MarkCanalsAndRiversAroundDirty(target);
 
+		/* Ships can sail here now */
+		YapfNotifyTrackLayoutChange(target, INVALID_TRACK);
+
 		/* update signals if needed */
 		UpdateSignalsInBuffer();
 	}
@@ -40,7 +40,7 @@ static inline bool IsValidWaypointID(WaypointID index)
 	return index < GetWaypointPoolSize() && GetWaypoint(index)->IsValid();
 }
 
-#define FOR_ALL_WAYPOINTS_FROM(wp, start) for (wp = GetWaypoint(start); wp != NULL; wp = (wp->index + 1U < GetWaypointPoolSize()) ? GetWaypoint(wp->index + 1U) : NULL) if (wp->IsValid())
+#define FOR_ALL_WAYPOINTS_FROM(wp, start) for (wp = _Waypoint_pool.GetNextLive(start); wp != NULL; wp = _Waypoint_pool.GetNextLive(wp->index + 1U)) if (wp->IsValid())
 #define FOR_ALL_WAYPOINTS(wp) FOR_ALL_WAYPOINTS_FROM(wp, 0)
 
 
@@ -9,6 +9,27 @@
 #include "../misc/hashtable.hpp"
 #include "../misc/binaryheap.hpp"
 
+/** Bookkeeping of the spare storages of all node list types, so they can be
+ *  accounted for and freed together. */
+struct CNodeListSpareBase
+{
+	typedef void FreeSpareProc();
+
+	enum {c_max_node_lists = 16};
+
+	static FreeSpareProc *s_free_spare[c_max_node_lists]; ///< FreeSpare() of each node list type that kept a spare storage
+	static uint   s_node_lists;  ///< number of valid entries in s_free_spare
+	static uint   s_spares;      ///< number of spare storages
+	static uint64 s_allocated;   ///< bytes taken by the spare storages
+	static bool   s_threaded;    ///< whether searches run on several threads; they then neither take nor keep spare storages
+
+	/** Free the spare storages of all node list types. */
+	static void FreeAllSpares()
+	{
+		for (uint i = 0; i < s_node_lists; i++) s_free_spare[i]();
+	}
+};
+
 /** Hash table based node list multi-container class.
  *  Implements open list, closed list and priority queue for A-star
  *  path finder. */
@@ -29,27 +50,105 @@ public:
 	typedef CBinaryHeapT<Titem_> CPriorityQueue;
 
 protected:
-	/** here we store full item data (Titem_) */
-	CItemArray            m_arr;
+	/** The containers of a node list. They are kept between searches so
+	 *  their memory is allocated only once, not for every search. */
+	struct CStorage {
+		/** here we store full item data (Titem_) */
+		CItemArray            m_arr;
+		/** hash table of pointers to open item data */
+		COpenList             m_open;
+		/** hash table of pointers to closed item data */
+		CClosedList           m_closed;
+		/** priority queue of pointers to open item data */
+		CPriorityQueue        m_open_queue;
+
+		CStorage() : m_open_queue(OPEN_QUEUE_SIZE) {}
+
+		/** Bytes taken by this storage. */
+		uint64 GetMemoryUsage() const
+		{
+			return sizeof(*this) + (uint64)m_arr.Size() * sizeof(Titem_) + (OPEN_QUEUE_SIZE + 1) * sizeof(Titem_*);
+		}
+	};
+
+	enum {OPEN_QUEUE_SIZE = 204800};
+
+	/** whether FreeSpare() of this node list type is known to CNodeListSpareBase */
+	static bool           s_registered;
+
+	/** storage of the last finished search, waiting to be reused by the next one */
+	static CStorage      *s_spare;
+
+	/** the storage used by this node list */
+	CStorage             *m_storage;
+	/** here we store full item data (Titem_); items beyond m_num_items are left over from earlier searches */
+	CItemArray           &m_arr;
 	/** hash table of pointers to open item data */
-	COpenList             m_open;
+	COpenList            &m_open;
 	/** hash table of pointers to closed item data */
-	CClosedList           m_closed;
+	CClosedList          &m_closed;
 	/** priority queue of pointers to open item data */
-	CPriorityQueue        m_open_queue;
+	CPriorityQueue       &m_open_queue;
+	/** number of items of m_arr used by this search */
+	int                   m_num_items;
+	/** the search node limit; decides how much memory is kept for the next search */
+	int                   m_max_nodes;
 	/** new open node under construction */
 	Titem                *m_new_node;
+
+	/** Take the spare storage, or allocate a new one when it is in use (by an enclosing search) */
+	static CStorage *AcquireStorage()
+	{
+		CStorage *storage = s_spare;
+		if (storage == NULL || CNodeListSpareBase::s_threaded) return new CStorage();
+		s_spare = NULL;
+		CNodeListSpareBase::s_spares--;
+		CNodeListSpareBase::s_allocated -= storage->GetMemoryUsage();
+		return storage;
+	}
+
+	/** Free the spare storage of this node list type. */
+	static void FreeSpare()
+	{
+		if (s_spare == NULL) return;
+		delete AcquireStorage();
+	}
+
 public:
 	/** default constructor */
 	CNodeList_HashTableT()
-		: m_open_queue(204800)
+		: m_storage(AcquireStorage())
+		, m_arr(m_storage->m_arr)
+		, m_open(m_storage->m_open)
+		, m_closed(m_storage->m_closed)
+		, m_open_queue(m_storage->m_open_queue)
+		, m_num_items(0)
+		, m_max_nodes(0)
 	{
 		m_new_node = NULL;
 	}
-	/** destructor */
+	/** destructor; keeps the storage for the next search unless
+	 *  it grew beyond what a search within the node limit needs */
 	~CNodeList_HashTableT()
 	{
+		if (s_spare != NULL || CNodeListSpareBase::s_threaded || m_arr.Size() > max(CItemArray::Tblock_size, 4 * m_max_nodes)) {
+			delete m_storage;
+			return;
+		}
+		m_open.Clear();
+		m_closed.Clear();
+		m_open_queue.Clear();
+		if (!s_registered) {
+			assert(CNodeListSpareBase::s_node_lists < CNodeListSpareBase::c_max_node_lists);
+			CNodeListSpareBase::s_free_spare[CNodeListSpareBase::s_node_lists++] = &FreeSpare;
+			s_registered = true;
+		}
+		s_spare = m_storage;
+		CNodeListSpareBase::s_spares++;
+		CNodeListSpareBase::s_allocated += m_storage->GetMemoryUsage();
 	}
+	/** set the maximum number of nodes the search closes, 0 if unlimited */
+	FORCEINLINE void SetMaxNodes(int max_nodes) {m_max_nodes = max_nodes;}
 	/** return number of open nodes */
 	FORCEINLINE int OpenCount() {return m_open.Count();}
 	/** return number of closed nodes */
@@ -57,7 +156,11 @@ public:
 	/** allocate new data item from m_arr */
 	FORCEINLINE Titem_* CreateNewNode()
 	{
-		if (m_new_node == NULL) m_new_node = &m_arr.Add();
+		if (m_new_node == NULL) {
+			/* reuse the items of earlier searches before growing the array */
+			m_new_node = (m_num_items < m_arr.Size()) ? new (&m_arr[m_num_items]) Titem_ : &m_arr.Add();
+			m_num_items++;
+		}
 		return m_new_node;
 	}
 	/** notify the nodelist, that we don't want to discard the given node */
@@ -125,7 +228,7 @@ public:
 		return item;
 	}
 
-	FORCEINLINE int TotalCount() {return m_arr.Size();}
+	FORCEINLINE int TotalCount() {return m_num_items;}
 	FORCEINLINE Titem_& ItemAt(int idx) {return m_arr[idx];}
 
 	template <class D> void Dump(D &dmp) const
@@ -134,4 +237,10 @@ public:
 	}
 };
 
+template <class Titem_, int Thash_bits_open_, int Thash_bits_closed_>
+typename CNodeList_HashTableT<Titem_, Thash_bits_open_, Thash_bits_closed_>::CStorage *CNodeList_HashTableT<Titem_, Thash_bits_open_, Thash_bits_closed_>::s_spare = NULL;
+
+template <class Titem_, int Thash_bits_open_, int Thash_bits_closed_>
+bool CNodeList_HashTableT<Titem_, Thash_bits_open_, Thash_bits_closed_>::s_registered = false;
+
 #endif /* NODELIST_HPP */
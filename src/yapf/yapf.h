@@ -16,6 +16,10 @@
  */
 Trackdir YapfChooseShipTrack(Vehicle *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks);
 
+void YapfQueueShipSearch(const Vehicle *v, TileIndex tile, DiagDirection enterdir);
+void YapfRunShipSearches();
+void YapfClearShipSearches();
+
 /** Finds the best path for given road vehicle.
  * @param v        the RV that needs to find a path
  * @param tile     the tile to find the path from (should be next tile the RV is about to enter)
@@ -66,9 +70,38 @@ bool YapfFindNearestRailDepotTwoWay(Vehicle *v, int max_distance, int reverse_pe
 /** Returns true if it is better to reverse the train before leaving station */
 bool YapfCheckReverseTrain(Vehicle* v);
 
-/** Use this function to notify YAPF that track layout (or signal configuration) has change */
+/** Use this function to notify YAPF that track, road or water layout (or signal configuration) has change.
+ * Only the cached segments and pathfinder regions that contain the tile are dropped; INVALID_TILE drops them all. */
 void YapfNotifyTrackLayoutChange(TileIndex tile, Track track);
 
+/** Statistics of the segment cost caches of the rail or road pathfinder. */
+struct YapfCacheStats {
+	uint64 hits;        ///< segment costs taken from a cache
+	uint64 misses;      ///< segment costs that had to be calculated
+	uint64 invalidated; ///< cached segments dropped because track or road they pass changed
+	uint flushes;       ///< number of times a whole cache was dropped
+	uint segments;      ///< number of segments in all caches
+};
+
+/** Get the statistics of the segment cost caches of the rail pathfinder */
+void YapfGetRailCacheStats(YapfCacheStats *stats);
+
+/** Get the statistics of the segment cost caches of the road pathfinder */
+void YapfGetRoadCacheStats(YapfCacheStats *stats);
+
+/** Get how often trains could take junctions from the route of an earlier path search;
+ *  'segments' is the number of trains that have such a route */
+void YapfGetRailRouteStats(YapfCacheStats *stats);
+
+/** Get the memory the segment cost caches of the rail and road pathfinders take */
+void YapfGetMemoryUsage(struct MemoryUsage *usage);
+
+/** Get the memory the node lists kept for the next path search take */
+void YapfGetNodeListMemoryUsage(struct MemoryUsage *usage);
+
+/** Get the memory the regions of the ship and road pathfinders take */
+void YapfGetRegionMemoryUsage(struct MemoryUsage *usage);
+
 /** performance measurement helpers */
 void* NpfBeginInterval();
 int NpfEndInterval(void* perf);
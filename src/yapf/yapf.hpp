@@ -79,6 +79,7 @@ typedef CPerfStartFake CPerfStart;
 #include "../misc/fixedsizearray.hpp"
 #include "../misc/array.hpp"
 #include "../misc/hashtable.hpp"
+#include "../misc/smallvec.h"
 #include "../misc/binaryheap.hpp"
 #include "../misc/dbg_helpers.h"
 #include "nodelist.hpp"
@@ -80,6 +80,7 @@ public:
 		, m_stats_cache_hits(0)
 		, m_num_steps(0)
 	{
+		m_nodes.SetMaxNodes(m_max_search_nodes);
 	}
 
 	/// default destructor
@@ -217,9 +218,7 @@ public:
 
 		bool bValid = Yapf().PfCalcCost(n, &tf);
 
-		if (bCached) {
-			Yapf().PfNodeCacheFlush(n);
-		}
+		Yapf().PfNodeCacheFlush(n);
 
 		if (bValid) bValid = Yapf().PfCalcEstimate(n);
 
@@ -72,16 +72,86 @@ public:
 };
 
 
-/** Base class for segment cost cache providers. Contains global counter
+/** Base class for segment cost cache providers. Contains the global log
  *  of track layout changes and static notification function called whenever
  *  the track layout changes. It is implemented as base class because it needs
- *  to be shared between all rail YAPF types (one shared counter, one notification
- *  function. */
+ *  to be shared between all rail and road YAPF types (one shared log, one
+ *  notification function). Each cache remembers up to which change it has
+ *  processed the log; a cache that fell behind more than c_change_log_size
+ *  changes is flushed. */
 struct CSegmentCostCacheBase
 {
-	static int   s_rail_change_counter;
+	enum {c_change_log_size = 64};
 
-	static void NotifyTrackLayoutChange(TileIndex tile, Track track) {s_rail_change_counter++;}
+	static uint  s_change_counter;
+	static TileIndex s_changed_tiles[c_change_log_size]; ///< last changed tiles, by s_change_counter; INVALID_TILE means everything changed
+	static uint  s_segments;      ///< number of segments in all caches
+	static uint  s_peak_segments; ///< highest number of segments in all caches at once
+	static uint  s_capacity;      ///< number of segments that fit in the blocks all caches allocated
+	static uint64 s_allocated;    ///< bytes allocated by all caches
+	static uint64 s_used;         ///< bytes taken by the segments in all caches
+
+	static void NotifyTrackLayoutChange(TileIndex tile, Track track)
+	{
+		s_changed_tiles[s_change_counter % c_change_log_size] = tile;
+		s_change_counter++;
+	}
+};
+
+
+/** The tiles a cached segment cost was calculated from, kept as a bounding
+ *  box, so track layout changes can find the segments they may affect. */
+struct CYapfSegmentArea
+{
+	uint16       m_min_x, m_min_y;   ///< north corner of the tiles read while calculating the cost
+	uint16       m_max_x, m_max_y;   ///< south corner of the tiles read while calculating the cost
+	uint         m_generation;       ///< number of times the segment was invalidated
+	bool         m_registered;       ///< whether the cache knows the tiles of the segment
+
+	FORCEINLINE CYapfSegmentArea()
+		: m_min_x(UINT16_MAX)
+		, m_min_y(UINT16_MAX)
+		, m_max_x(0)
+		, m_max_y(0)
+		, m_generation(0)
+		, m_registered(false)
+	{}
+
+	/** Forget the tiles; any reference the cache still has to the segment becomes stale. */
+	FORCEINLINE void ResetArea()
+	{
+		m_min_x = m_min_y = UINT16_MAX;
+		m_max_x = m_max_y = 0;
+		m_generation++;
+		m_registered = false;
+	}
+
+	/** Remember that calculating the cost of the segment read the given tile. */
+	FORCEINLINE void AddTile(TileIndex tile)
+	{
+		m_min_x = min<uint>(m_min_x, TileX(tile));
+		m_min_y = min<uint>(m_min_y, TileY(tile));
+		m_max_x = max<uint>(m_max_x, TileX(tile));
+		m_max_y = max<uint>(m_max_y, TileY(tile));
+	}
+
+	/** Get the area of the tiles read while calculating the cost, extended
+	 *  by the neighbours that were looked at to find the end of the segment. */
+	FORCEINLINE void GetArea(uint *x1, uint *y1, uint *x2, uint *y2) const
+	{
+		*x1 = max<uint>(m_min_x, 1) - 1;
+		*y1 = max<uint>(m_min_y, 1) - 1;
+		*x2 = m_max_x + 1;
+		*y2 = m_max_y + 1;
+	}
+
+	/** Could a change of the given tile change the cost of this segment? */
+	FORCEINLINE bool ContainsTile(TileIndex tile) const
+	{
+		uint x1, y1, x2, y2;
+		GetArea(&x1, &y1, &x2, &y2);
+		return IsInsideMM(TileX(tile), x1, x2 + 1) && IsInsideMM(TileY(tile), y1, y2 + 1);
+	}
 };
 
 
@@ -92,39 +162,158 @@ struct CSegmentCostCacheBase
  *  be always the same (TileIndex + DiagDirection) that represent the beginning
  *  of the segment (origin tile and exit-dir from this tile).
  *  Different CYapfCachedCostT types can share the same type of CSegmentCostCacheT.
- *  Look at CYapfRailSegment (yapf_node_rail.hpp) for the segment example */
+ *  Look at CYapfRailSegment (yapf_node_rail.hpp) or CYapfRoadSegment
+ *  (yapf_node_road.hpp) for the segment example.
+ *
+ *  Once its cost is known, each segment is registered in the areas of
+ *  (1 << c_area_bits) x (1 << c_area_bits) tiles its tiles are in, so a track
+ *  layout change only needs to look at the segments of one area. Invalidated
+ *  segments stay in the hash and the heap; their cost is simply calculated
+ *  again the next time they are used. */
 template <class Tsegment>
 struct CSegmentCostCacheT
 	: public CSegmentCostCacheBase
 {
-	enum {c_hash_bits = 14};
+	enum {c_hash_bits = 14, c_area_bits = 4};
 
 	typedef CHashTableT<Tsegment, c_hash_bits> HashTable;
 	typedef CArrayT<Tsegment> Heap;
 	typedef typename Tsegment::Key Key;    ///< key to hash table
 
+	/** Reference from an area to a segment; stale when the segment was invalidated since. */
+	struct AreaRef {
+		Tsegment *segment;
+		uint      generation; ///< the generation of the segment when it was registered
+	};
+	typedef SmallVector<AreaRef, 4> Area;
+
 	HashTable    m_map;
 	Heap         m_heap;
+	Area        *m_areas;       ///< segments that have a tile in each area
+	uint         m_areas_x;     ///< number of areas along the X axis
+	uint         m_areas_y;     ///< number of areas along the Y axis
+	uint         m_change_counter; ///< value of s_change_counter up to which changes were processed
 
-	FORCEINLINE CSegmentCostCacheT() {}
+	static YapfCacheStats s_stats; ///< statistics of all caches of this segment type
+
+	FORCEINLINE CSegmentCostCacheT() : m_areas(NULL), m_areas_x(0), m_areas_y(0), m_change_counter(s_change_counter)
+	{
+		s_allocated += HashTable::Tcapacity * sizeof(Tsegment*) + Heap::Tnum_blocks * sizeof(typename Heap::CSubArray);
+	}
+
+	~CSegmentCostCacheT()
+	{
+		delete[] m_areas;
+	}
 
 	/** flush (clear) the cache */
-	FORCEINLINE void Flush() {m_map.Clear(); m_heap.Clear();};
+	FORCEINLINE void Flush()
+	{
+		uint blocks = (m_heap.Size() + Heap::Tblock_size - 1) / Heap::Tblock_size;
+		s_segments -= m_heap.Size();
+		s_stats.segments -= m_heap.Size();
+		s_used -= (uint64)m_heap.Size() * sizeof(Tsegment);
+		s_capacity -= blocks * Heap::Tblock_size;
+		s_allocated -= (uint64)blocks * Heap::Tblock_size * sizeof(Tsegment);
+		s_allocated -= (uint64)m_areas_x * m_areas_y * sizeof(Area);
+		s_stats.flushes++;
+		m_map.Clear();
+		m_heap.Clear();
+
+		/* The map may have another size than when the areas were made */
+		delete[] m_areas;
+		m_areas_x = max(MapSizeX() >> c_area_bits, 1U);
+		m_areas_y = max(MapSizeY() >> c_area_bits, 1U);
+		m_areas = new Area[m_areas_x * m_areas_y];
+		s_allocated += (uint64)m_areas_x * m_areas_y * sizeof(Area);
+	};
 
 	FORCEINLINE Tsegment& Get(Key& key, bool *found)
 	{
 		Tsegment* item = m_map.Find(key);
 		if (item == NULL) {
 			*found = false;
+			if (m_heap.Size() % Heap::Tblock_size == 0) {
+				s_capacity += Heap::Tblock_size;
+				s_allocated += Heap::Tblock_size * sizeof(Tsegment);
+			}
+			s_segments++;
+			s_stats.segments++;
+			s_used += sizeof(Tsegment);
+			s_peak_segments = max(s_peak_segments, s_segments);
 			item = new (&m_heap.AddNC()) Tsegment(key);
 			m_map.Push(*item);
 		} else {
-			*found = true;
+			*found = item->IsCostCached();
 		}
 		return *item;
 	}
+
+	/** Register a segment of which the cost was just calculated in the areas its tiles are in. */
+	void Register(Tsegment& segment)
+	{
+		if (!segment.IsCostCached() || segment.m_registered || m_areas == NULL) return;
+
+		uint x1, y1, x2, y2;
+		segment.GetArea(&x1, &y1, &x2, &y2);
+		AreaRef ref = {&segment, segment.m_generation};
+		for (uint y = min(y1 >> c_area_bits, m_areas_y - 1); y <= min(y2 >> c_area_bits, m_areas_y - 1); y++) {
+			for (uint x = min(x1 >> c_area_bits, m_areas_x - 1); x <= min(x2 >> c_area_bits, m_areas_x - 1); x++) {
+				*m_areas[y * m_areas_x + x].Append() = ref;
+			}
+		}
+		segment.m_registered = true;
+	}
+
+	/** Invalidate all segments that may have read the given tile. */
+	void Invalidate(TileIndex tile)
+	{
+		Area &area = m_areas[min(TileY(tile) >> c_area_bits, m_areas_y - 1) * m_areas_x + min(TileX(tile) >> c_area_bits, m_areas_x - 1)];
+		uint kept = 0;
+		for (uint i = 0; i < area.Length(); i++) {
+			AreaRef ref = area[i];
+			if (ref.generation != ref.segment->m_generation) continue;
+			if (ref.segment->ContainsTile(tile)) {
+				ref.segment->Invalidate();
+				s_stats.invalidated++;
+				continue;
+			}
+			area[kept++] = ref;
+		}
+		area.items = kept;
+	}
+
+	/** Process the track layout changes since the last call. */
+	void ProcessChanges()
+	{
+		if (m_areas == NULL || m_areas_x != max(MapSizeX() >> c_area_bits, 1U) || m_areas_y != max(MapSizeY() >> c_area_bits, 1U)) {
+			m_change_counter = s_change_counter;
+			Flush();
+			return;
+		}
+
+		if (m_change_counter == s_change_counter) return;
+
+		if (s_change_counter - m_change_counter > (uint)c_change_log_size) {
+			m_change_counter = s_change_counter;
+			Flush();
+			return;
+		}
+
+		for (; m_change_counter != s_change_counter; m_change_counter++) {
+			TileIndex tile = s_changed_tiles[m_change_counter % c_change_log_size];
+			if (tile == INVALID_TILE || tile >= MapSize()) {
+				m_change_counter = s_change_counter;
+				Flush();
+				return;
+			}
+			Invalidate(tile);
+		}
+	}
 };
 
+template <class Tsegment> YapfCacheStats CSegmentCostCacheT<Tsegment>::s_stats;
+
 /** CYapfSegmentCostCacheGlobalT - the yapf cost cache provider that adds the segment cost
  *  caching functionality to yapf. Using this class as base of your will provide the global
  *  segment cost caching services for your Nodes.
@@ -152,7 +341,6 @@ protected:
 
 	FORCEINLINE static Cache& stGetGlobalCache()
 	{
-		static int last_rail_change_counter = 0;
 		static Date last_date = 0;
 		static Cache C;
 
@@ -163,11 +351,8 @@ protected:
 			_total_pf_time_us = 0;
 		}
 
-		// delete the cache sometimes...
-		if (last_rail_change_counter != Cache::s_rail_change_counter) {
-			last_rail_change_counter = Cache::s_rail_change_counter;
-			C.Flush();
-		}
+		// drop the segments the track layout changes went through
+		C.ProcessChanges();
 		return C;
 	}
 
@@ -183,13 +368,20 @@ public:
 		bool found;
 		CachedData& item = m_global_cache.Get(key, &found);
 		Yapf().ConnectNodeToCachedData(n, item);
+		if (found) {
+			Cache::s_stats.hits++;
+		} else {
+			Cache::s_stats.misses++;
+		}
 		return found;
 	};
 
-	/** Called by YAPF to flush the cached segment cost data back into cache storage.
-	 *  Current cache implementation doesn't use that. */
+	/** Called by YAPF after the cost of the node was calculated; registers newly
+	 *  calculated segments so track layout changes can find them. */
 	FORCEINLINE void PfNodeCacheFlush(Node& n)
 	{
+		if (!Yapf().CanUseGlobalCache(n)) return;
+		m_global_cache.Register(*n.m_segment);
 	};
 
 };
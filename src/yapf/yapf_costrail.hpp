@@ -280,6 +280,9 @@ public:
 			goto no_entry_cost;
 		}
 
+		/* The tiles skipped to get to the first tile count as part of the segment. */
+		if (!is_cached_segment) segment.AddTile(prev.tile);
+
 		for (;;) {
 			/* Transition cost (cost of the move from previous tile) */
 			transition_cost = Yapf().CurveCost(prev.td, cur.td);
@@ -318,6 +321,9 @@ public:
 
 no_entry_cost: // jump here at the beginning if the node has no parent (it is the first node)
 
+			/* Remember the tiles of the segment, so changes to them invalidate it. */
+			segment.AddTile(cur.tile);
+
 			/* All other tile costs will be calculated here. */
 			segment_cost += Yapf().OneTileCost(cur.tile, cur.td);
 
@@ -385,6 +391,7 @@ no_entry_cost: // jump here at the beginning if the node has no parent (it is th
 				}
 				break;
 			}
+			segment.AddTile(tf_local.m_new_tile);
 
 			/* Check if the next tile is not a choice. */
 			if (KillFirstBit(tf_local.m_new_td_bits) != TRACKDIR_BIT_NONE) {
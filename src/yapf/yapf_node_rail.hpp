@@ -97,6 +97,7 @@ inline CStrA ValueStr(EndSegmentReasonBits bits)
 
 /** cached segment cost for rail YAPF */
 struct CYapfRailSegment
+	: public CYapfSegmentArea
 {
 	typedef CYapfRailSegmentKey Key;
 
@@ -120,6 +121,20 @@ struct CYapfRailSegment
 		, m_hash_next(NULL)
 	{}
 
+	/** Forget the cost, so it is calculated again the next time the segment is used. */
+	FORCEINLINE void Invalidate()
+	{
+		m_last_tile = INVALID_TILE;
+		m_last_td = INVALID_TRACKDIR;
+		m_cost = -1;
+		m_last_signal_tile = INVALID_TILE;
+		m_last_signal_td = INVALID_TRACKDIR;
+		m_end_segment_reason = ESRB_NONE;
+		ResetArea();
+	}
+
+	FORCEINLINE bool IsCostCached() const {return m_cost >= 0;}
+
 	FORCEINLINE const Key& GetKey() const {return m_key;}
 	FORCEINLINE TileIndex GetTile() const {return m_key.GetTile();}
 	FORCEINLINE CYapfRailSegment* GetHashNext() {return m_hash_next;}
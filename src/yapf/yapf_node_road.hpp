@@ -5,7 +5,87 @@
 #ifndef  YAPF_NODE_ROAD_HPP
 #define  YAPF_NODE_ROAD_HPP
 
+/** key for cached segment cost for road YAPF; road vehicles of different owners
+ *  or road types can follow different roads from the same tile */
+struct CYapfRoadSegmentKey
+{
+	uint32    m_value;   ///< tile and trackdir the segment starts with
+	uint16    m_vehicle; ///< owner and compatible road types of the vehicles that can use the segment
+
+	FORCEINLINE CYapfRoadSegmentKey(const CYapfRoadSegmentKey& src) : m_value(src.m_value), m_vehicle(src.m_vehicle) {}
+	FORCEINLINE CYapfRoadSegmentKey(TileIndex tile, Trackdir td, const Vehicle *v) {Set(tile, td, v);}
+
+	FORCEINLINE void Set(TileIndex tile, Trackdir td, const Vehicle *v)
+	{
+		m_value = (((int)tile) << 4) | td;
+		m_vehicle = (v->owner << 4) | v->u.road.compatible_roadtypes;
+	}
+
+	FORCEINLINE int32 CalcHash() const {return m_value ^ (m_vehicle << 4);}
+	FORCEINLINE TileIndex GetTile() const {return (TileIndex)(m_value >> 4);}
+	FORCEINLINE Trackdir GetTrackdir() const {return (Trackdir)(m_value & 0x0F);}
+	FORCEINLINE bool operator == (const CYapfRoadSegmentKey& other) const {return m_value == other.m_value && m_vehicle == other.m_vehicle;}
+
+	void Dump(DumpTarget &dmp) const
+	{
+		dmp.WriteTile("tile", GetTile());
+		dmp.WriteEnumT("td", GetTrackdir());
+		dmp.WriteLine("vehicle = 0x%04X", m_vehicle);
+	}
+};
+
+/** cached segment cost for road YAPF */
+struct CYapfRoadSegment
+	: public CYapfSegmentArea
+{
+	typedef CYapfRoadSegmentKey Key;
+
+	CYapfRoadSegmentKey    m_key;
+	TileIndex              m_last_tile;
+	Trackdir               m_last_td;
+	int                    m_cost;             ///< cost of the segment without speed limit penalties, -1 if not known
+	int                    m_max_speed;        ///< lowest speed limit on the segment; slower vehicles pay no penalty
+	bool                   m_loop;             ///< the segment is a simple loop without junctions
+	CYapfRoadSegment*      m_hash_next;
+
+	FORCEINLINE CYapfRoadSegment(const CYapfRoadSegmentKey& key)
+		: m_key(key)
+		, m_last_tile(INVALID_TILE)
+		, m_last_td(INVALID_TRACKDIR)
+		, m_cost(-1)
+		, m_max_speed(INT_MAX)
+		, m_loop(false)
+		, m_hash_next(NULL)
+	{}
+
+	/** Forget the cost, so it is calculated again the next time the segment is used. */
+	FORCEINLINE void Invalidate()
+	{
+		m_last_tile = INVALID_TILE;
+		m_last_td = INVALID_TRACKDIR;
+		m_cost = -1;
+		m_max_speed = INT_MAX;
+		m_loop = false;
+		ResetArea();
+	}
 
+	FORCEINLINE bool IsCostCached() const {return m_cost >= 0;}
+
+	FORCEINLINE const Key& GetKey() const {return m_key;}
+	FORCEINLINE TileIndex GetTile() const {return m_key.GetTile();}
+	FORCEINLINE CYapfRoadSegment* GetHashNext() {return m_hash_next;}
+	FORCEINLINE void SetHashNext(CYapfRoadSegment* next) {m_hash_next = next;}
+
+	void Dump(DumpTarget &dmp) const
+	{
+		dmp.WriteStructT("m_key", &m_key);
+		dmp.WriteTile("m_last_tile", m_last_tile);
+		dmp.WriteEnumT("m_last_td", m_last_td);
+		dmp.WriteLine("m_cost = %d", m_cost);
+		dmp.WriteLine("m_max_speed = %d", m_max_speed);
+		dmp.WriteLine("m_loop = %s", m_loop ? "Yes" : "No");
+	}
+};
 
 /** Yapf Node for road YAPF */
 template <class Tkey_>
@@ -16,12 +96,14 @@ struct CYapfRoadNodeT
 
 	TileIndex       m_segment_last_tile;
 	Trackdir        m_segment_last_td;
+	CYapfRoadSegment *m_segment;
 
 	void Set(CYapfRoadNodeT* parent, TileIndex tile, Trackdir td, bool is_choice)
 	{
 		base::Set(parent, tile, td, is_choice);
 		m_segment_last_tile = tile;
 		m_segment_last_td = td;
+		m_segment = NULL;
 	}
 };
 
@@ -8,12 +8,42 @@
 #include "yapf_node_rail.hpp"
 #include "yapf_costrail.hpp"
 #include "yapf_destrail.hpp"
+#include "yapf_regions.hpp"
 #include "../vehicle_func.h"
+#include "../train.h"
+#include "../meminfo.h"
 
 #define DEBUG_YAPF_CACHE 0
 
 int _total_pf_time_us = 0;
 
+static YapfCacheStats _rail_route_stats; ///< statistics of the routes trains follow through junctions
+
+/** The trains that got a route since the last reset; also some whose route is gone by now */
+static SmallVector<VehicleID, 64> _rail_route_trains;
+
+/** Put a train that gets a route in the list of trains with a route. */
+static void AddRailRouteTrain(Vehicle *v)
+{
+	if (v->u.rail.route.listed) return;
+	v->u.rail.route.listed = true;
+	*_rail_route_trains.Append() = v->index;
+}
+
+/**
+ * Check whether a train asks for the way when entering a tile, i.e. whether
+ * more than one track is reachable; see TrainController().
+ * @param tile     the tile the train enters
+ * @param enterdir the direction the train enters the tile in
+ * @param prev_td  the trackdir of the train on the previous tile
+ */
+static bool IsRailJunction(TileIndex tile, DiagDirection enterdir, Trackdir prev_td)
+{
+	TrackdirBits trackdirs = TrackStatusToTrackdirBits(GetTileTrackStatus(tile, TRANSPORT_RAIL, 0, ReverseDiagDir(enterdir))) & DiagdirReachesTrackdirs(enterdir);
+	TrackBits tracks = TrackdirBitsToTrackBits(trackdirs);
+	if (_patches.forbid_90_deg) tracks &= ~TrackCrossesTracks(TrackdirToTrack(prev_td));
+	return KillFirstBit(tracks) != TRACK_BIT_NONE;
+}
 
 
 
@@ -103,6 +133,10 @@ public:
 	typedef typename Types::NodeList::Titem Node;        ///< this will be our node type
 	typedef typename Node::Key Key;                      ///< key to hash tables
 
+	enum {
+		MAX_ROUTE_TILES = 4096, ///< number of tiles SetRoute() follows the path for at most
+	};
+
 protected:
 	/// to access inherited path finder
 	FORCEINLINE Tpf& Yapf() {return *static_cast<Tpf*>(this);}
@@ -177,10 +211,74 @@ public:
 			Node& best_next_node = *pPrev;
 			assert(best_next_node.GetTile() == tile);
 			next_trackdir = best_next_node.GetTrackdir();
+
+			if (path_found) SetRoute(v, Yapf().GetBestNode(), &best_next_node);
 		}
 		return next_trackdir;
 	}
 
+	/**
+	 * Store the way through the junctions after the one the train is entering,
+	 * so it doesn't need to search its path again at each of them.
+	 * @param v     the train
+	 * @param best  the last node of the path
+	 * @param first the node of the junction the train is entering
+	 */
+	FORCEINLINE void SetRoute(Vehicle *v, Node *best, Node *first)
+	{
+		/* The path is linked from its end, so collect it to go through it from the train on */
+		SmallVector<Node*, 64> path;
+		for (Node *n = best; n != first; n = n->m_parent) *path.Append() = n;
+
+		RailRouteCache &route = v->u.rail.route;
+		route.dest_tile = v->dest_tile;
+		route.length = 0;
+		route.pos = 0;
+
+		/* Go along the path tile by tile and store the way at every tile the train
+		 * asks for it. Those are not only the ends of segments: a branch of another
+		 * railtype, for one, is no choice for the pathfinder but is for the train. */
+		TileIndex tile = first->GetTile();
+		Trackdir td = first->GetTrackdir();
+		uint x1 = TileX(tile), y1 = TileY(tile), x2 = x1, y2 = y1;
+		Node *n = first;
+		uint next = path.Length(); // path.Begin()[next - 1] is the node after n
+		TrackFollower F(v);
+		for (uint steps = 0; steps < MAX_ROUTE_TILES; steps++) {
+			Trackdir prev_td = td;
+			if (tile == n->GetLastTile() && td == n->GetLastTrackdir()) {
+				/* End of a segment, the path continues with the next node */
+				if (next == 0) break;
+				n = path.Begin()[--next];
+				if (!F.Follow(tile, td) || F.m_new_tile != n->GetTile() || !HasBit(F.m_new_td_bits, n->GetTrackdir())) break;
+				td = n->GetTrackdir();
+			} else {
+				/* Within a segment there is only one way to go */
+				if (!F.Follow(tile, td) || KillFirstBit(F.m_new_td_bits) != TRACKDIR_BIT_NONE) break;
+				td = (Trackdir)FindFirstBit2x64(F.m_new_td_bits);
+			}
+			tile = F.m_new_tile;
+
+			if (IsRailJunction(tile, F.m_exitdir, prev_td)) {
+				if (route.length == RAIL_ROUTE_CACHE_SIZE) break;
+				route.decisions[route.length++] = tile << 4 | td;
+			}
+
+			/* Tunnels, bridges and stations are skipped, but lie between their ends */
+			x1 = min(x1, TileX(tile));
+			y1 = min(y1, TileY(tile));
+			x2 = max(x2, TileX(tile));
+			y2 = max(y2, TileY(tile));
+		}
+
+		route.min_x = x1;
+		route.min_y = y1;
+		route.max_x = x2;
+		route.max_y = y2;
+
+		if (route.length != 0) AddRailRouteTrain(v);
+	}
+
 	static bool stCheckReverseTrain(Vehicle* v, TileIndex t1, Trackdir td1, TileIndex t2, Trackdir td2, int reverse_penalty)
 	{
 		Tpf pf1;
@@ -247,8 +345,63 @@ struct CYapfAnyDepotRail1 : CYapfT<CYapfRail_TypesT<CYapfAnyDepotRail1, CFollowT
 struct CYapfAnyDepotRail2 : CYapfT<CYapfRail_TypesT<CYapfAnyDepotRail2, CFollowTrackRailNo90, CRailNodeListTrackDir, CYapfDestinationAnyDepotRailT     , CYapfFollowAnyDepotRailT> > {};
 
 
+/**
+ * Check whether the first signal a train meets after taking a trackdir
+ * shows red; only the signals before the next junction are looked at.
+ */
+static bool IsNextSignalRed(const Vehicle *v, TileIndex tile, Trackdir td)
+{
+	CFollowTrackRail F(v);
+	for (uint i = 0; i < 64; i++) {
+		if (IsTileType(tile, MP_RAILWAY) && HasSignalOnTrackdir(tile, td)) {
+			return GetSignalStateByTrackdir(tile, td) == SIGNAL_STATE_RED;
+		}
+		if (!F.Follow(tile, td) || KillFirstBit(F.m_new_td_bits) != TRACKDIR_BIT_NONE) break;
+		tile = F.m_new_tile;
+		td = (Trackdir)FindFirstBit2x64(F.m_new_td_bits);
+	}
+	return false;
+}
+
+/**
+ * Take the way through a junction from the route of an earlier path search.
+ * The route is dropped when the destination changed, the train left it or
+ * the signal behind the junction turned red.
+ * @return the trackdir to take, INVALID_TRACKDIR if the path has to be searched
+ */
+static Trackdir FollowRailRoute(Vehicle *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks)
+{
+	RailRouteCache &route = v->u.rail.route;
+	if (route.pos >= route.length) return INVALID_TRACKDIR;
+
+	if (route.dest_tile == v->dest_tile) {
+		for (uint i = route.pos; i < route.length; i++) {
+			if ((route.decisions[i] >> 4) != tile) continue;
+
+			Trackdir td = (Trackdir)GB(route.decisions[i], 0, 4);
+			if (!HasBit(tracks, TrackdirToTrack(td)) || (TrackdirToTrackdirBits(td) & DiagdirReachesTrackdirs(enterdir)) == TRACKDIR_BIT_NONE) break;
+			if (IsNextSignalRed(v, tile, td)) break;
+
+			route.pos = i + 1;
+			_rail_route_stats.hits++;
+			return td;
+		}
+	}
+
+	route.length = 0;
+	_rail_route_stats.invalidated++;
+	return INVALID_TRACKDIR;
+}
+
 Trackdir YapfChooseRailTrack(Vehicle *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool *path_not_found)
 {
+	Trackdir td_ret = FollowRailRoute(v, tile, enterdir, tracks);
+	if (td_ret != INVALID_TRACKDIR) {
+		if (path_not_found != NULL) *path_not_found = false;
+		return td_ret;
+	}
+	_rail_route_stats.misses++;
+
 	// default is YAPF type 2
 	typedef Trackdir (*PfnChooseRailTrack)(Vehicle*, TileIndex, DiagDirection, TrackBits, bool*);
 	PfnChooseRailTrack pfnChooseRailTrack = &CYapfRail1::stChooseRailTrack;
@@ -258,7 +411,7 @@ Trackdir YapfChooseRailTrack(Vehicle *v, TileIndex tile, DiagDirection enterdir,
 		pfnChooseRailTrack = &CYapfRail2::stChooseRailTrack; // Trackdir, forbid 90-deg
 	}
 
-	Trackdir td_ret = pfnChooseRailTrack(v, tile, enterdir, tracks, path_not_found);
+	td_ret = pfnChooseRailTrack(v, tile, enterdir, tracks, path_not_found);
 
 	return td_ret;
 }
@@ -349,7 +502,119 @@ bool YapfFindNearestRailDepotTwoWay(Vehicle *v, int max_distance, int reverse_pe
 	return ret;
 }
 
-/** if any track changes, this counter is incremented - that will invalidate segment cost cache */
-int CSegmentCostCacheBase::s_rail_change_counter = 0;
+/** if any track or road changes, this counter is incremented and the tile is logged - that will invalidate the segments through it */
+uint CSegmentCostCacheBase::s_change_counter = 0;
+TileIndex CSegmentCostCacheBase::s_changed_tiles[CSegmentCostCacheBase::c_change_log_size];
+uint CSegmentCostCacheBase::s_segments = 0;
+uint CSegmentCostCacheBase::s_peak_segments = 0;
+uint CSegmentCostCacheBase::s_capacity = 0;
+uint64 CSegmentCostCacheBase::s_allocated = 0;
+uint64 CSegmentCostCacheBase::s_used = 0;
+
+CNodeListSpareBase::FreeSpareProc *CNodeListSpareBase::s_free_spare[CNodeListSpareBase::c_max_node_lists];
+uint CNodeListSpareBase::s_node_lists = 0;
+uint CNodeListSpareBase::s_spares = 0;
+uint64 CNodeListSpareBase::s_allocated = 0;
+bool CNodeListSpareBase::s_threaded = false;
+
+void YapfGetMemoryUsage(MemoryUsage *usage)
+{
+	usage->name = "yapf_segment_cache";
+	usage->allocated = CSegmentCostCacheBase::s_allocated;
+	usage->items = CSegmentCostCacheBase::s_segments;
+	usage->capacity = CSegmentCostCacheBase::s_capacity;
+	usage->peak = CSegmentCostCacheBase::s_peak_segments;
+	usage->used = CSegmentCostCacheBase::s_used;
+}
+
+void YapfGetNodeListMemoryUsage(MemoryUsage *usage)
+{
+	usage->name = "yapf_spare_node_lists";
+	usage->allocated = CNodeListSpareBase::s_allocated;
+	usage->used = 0;
+	usage->items = CNodeListSpareBase::s_spares;
+	usage->capacity = CNodeListSpareBase::s_node_lists;
+	usage->peak = 0;
+}
+
+void YapfGetRailCacheStats(YapfCacheStats *stats)
+{
+	*stats = CSegmentCostCacheT<CYapfRailSegment>::s_stats;
+}
+
+void YapfGetRailRouteStats(YapfCacheStats *stats)
+{
+	*stats = _rail_route_stats;
+	stats->segments = 0;
+
+	for (const VehicleID *id = _rail_route_trains.Begin(); id != _rail_route_trains.End(); id++) {
+		if (!IsValidVehicleID(*id)) continue;
+		const Vehicle *v = GetVehicle(*id);
+		if (v->type == VEH_TRAIN && v->u.rail.route.listed && v->u.rail.route.pos < v->u.rail.route.length) stats->segments++;
+	}
+}
+
+/**
+ * Drop the routes of the trains that pass the given tile. Trains whose
+ * route is gone, or that are gone themselves, leave the list as well.
+ */
+static void InvalidateRailRoutes(TileIndex tile)
+{
+	uint x = TileX(tile);
+	uint y = TileY(tile);
+
+	for (VehicleID *id = _rail_route_trains.Begin(); id != _rail_route_trains.End();) {
+		Vehicle *v = IsValidVehicleID(*id) ? GetVehicle(*id) : NULL;
+		/* A train that is gone may have left its slot to another vehicle */
+		if (v == NULL || v->type != VEH_TRAIN || !v->u.rail.route.listed) {
+			_rail_route_trains.Erase(id);
+			continue;
+		}
+
+		RailRouteCache &route = v->u.rail.route;
+		if (route.pos < route.length && IsInsideMM(x, route.min_x, route.max_x + 1) && IsInsideMM(y, route.min_y, route.max_y + 1)) {
+			route.length = 0;
+			_rail_route_stats.invalidated++;
+		}
+		if (route.pos >= route.length) {
+			route.listed = false;
+			_rail_route_trains.Erase(id);
+			continue;
+		}
+		id++;
+	}
+}
+
+/** Make the list of trains with a route match the trains, e.g. after loading a game. */
+static void RebuildRailRouteTrains()
+{
+	_rail_route_trains.Clear();
+
+	Vehicle *v;
+	FOR_ALL_VEHICLES(v) {
+		if (v->type != VEH_TRAIN) continue;
+
+		v->u.rail.route.listed = false;
+		if (IsFrontEngine(v) && v->u.rail.route.pos < v->u.rail.route.length) AddRailRouteTrain(v);
+	}
+}
 
-void YapfNotifyTrackLayoutChange(TileIndex tile, Track track) {CSegmentCostCacheBase::NotifyTrackLayoutChange(tile, track);}
+void YapfNotifyTrackLayoutChange(TileIndex tile, Track track)
+{
+	CSegmentCostCacheBase::NotifyTrackLayoutChange(tile, track);
+	InvalidateRegions(tile);
+	/* The ship searches of this tick may take another way on the changed map */
+	YapfClearShipSearches();
+
+	if (tile == INVALID_TILE) {
+		/* The routes of the trains are saved with them, so they must stay when
+		 * everything is reset after loading a game; only real changes drop them */
+		RebuildRailRouteTrains();
+		/* The node lists of the searches of the previous game need not stay around */
+		CNodeListSpareBase::FreeAllSpares();
+	} else if (track != INVALID_TRACK) {
+		/* Only changed rail tracks can cut a route; road, water
+		 * and the like are notified without a track */
+		InvalidateRailRoutes(tile);
+	}
+}
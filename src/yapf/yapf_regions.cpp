@@ -0,0 +1,324 @@
+/* $Id$ */
+
+/** @file yapf_regions.cpp Division of the map into regions of known connectivity, used to plan long routes of ships and road vehicles. */
+
+#include "../stdafx.h"
+
+#include "yapf.hpp"
+#include "yapf_regions.hpp"
+#include "../meminfo.h"
+
+#include "../safeguards.h"
+
+/** Connection from a tile of a patch to a tile outside the region of the patch. */
+struct RegionEdge {
+	byte      patch; ///< the patch the connection starts in
+	TileIndex tile;  ///< the tile outside the region a vehicle ends up on
+};
+
+/** The ways of one type in one region, split into patches. */
+struct Region {
+	bool        valid;       ///< whether the patches and edges match the map
+	byte        num_patches; ///< number of patches in the region
+	uint16      num_edges;   ///< number of connections to other regions
+	uint16      max_edges;   ///< number of connections that fit in 'edges'
+	RegionEdge *edges;       ///< connections to other regions
+	byte        patch[REGION_TILES]; ///< the patch of each tile of the region, 0 when vehicles can't use the tile
+};
+
+static Region **_regions[REGION_TYPE_END];   ///< the regions of each type, each calculated when it is first used
+static uint _regions_x = 0;                  ///< number of regions along the X axis of the map
+static uint _regions_y = 0;                  ///< number of regions along the Y axis of the map
+static uint _regions_valid[REGION_TYPE_END]; ///< number of regions of each type that match the map
+
+/** Get the trackdirs vehicles can use on a tile. */
+static inline TrackdirBits GetRegionTrackdirs(RegionType type, TileIndex tile)
+{
+	switch (type) {
+		case REGION_WATER: return TrackStatusToTrackdirBits(GetTileTrackStatus(tile, TRANSPORT_WATER, 0));
+		case REGION_ROAD:  return TrackStatusToTrackdirBits(GetTileTrackStatus(tile, TRANSPORT_ROAD, ROADTYPES_ROAD));
+		case REGION_TRAM:  return TrackStatusToTrackdirBits(GetTileTrackStatus(tile, TRANSPORT_ROAD, ROADTYPES_TRAM));
+		default: NOT_REACHED(); return TRACKDIR_BIT_NONE;
+	}
+}
+
+/** Get the side road vehicles enter and leave a road stop or depot by, INVALID_DIAGDIR for other tiles. */
+static inline DiagDirection GetRoadEntrance(TileIndex tile)
+{
+	if (IsStandardRoadStopTile(tile)) return GetRoadStopDir(tile);
+	if (IsTileDepotType(tile, TRANSPORT_ROAD)) return GetRoadDepotDirection(tile);
+	return INVALID_DIAGDIR;
+}
+
+/**
+ * Get the tile a vehicle ends up on when leaving a tile in the given direction.
+ * Depot ownership is left out, so the regions are the same for everybody.
+ * @param type      the kind of ways to follow
+ * @param tile      the tile the vehicle leaves
+ * @param trackdirs the trackdirs vehicles can use on the tile
+ * @param dir       the direction to leave the tile in
+ * @return the tile the vehicle enters, or INVALID_TILE when it can't go that way
+ */
+static TileIndex GetRegionNeighbour(RegionType type, TileIndex tile, TrackdirBits trackdirs, DiagDirection dir)
+{
+	TrackdirBits exits = trackdirs;
+	for (; exits != TRACKDIR_BIT_NONE; exits = KillFirstBit(exits)) {
+		if (TrackdirToExitdir((Trackdir)FindFirstBit2x64(exits)) == dir) break;
+	}
+	if (exits == TRACKDIR_BIT_NONE) return INVALID_TILE;
+
+	DiagDirection entrance = (type == REGION_WATER) ? INVALID_DIAGDIR : GetRoadEntrance(tile);
+	if (entrance != INVALID_DIAGDIR && entrance != dir) return INVALID_TILE;
+
+	TileIndex next;
+	if (IsTileType(tile, MP_TUNNELBRIDGE) && GetTunnelBridgeDirection(tile) == dir) {
+		/* Vehicles pass tunnels, bridges and aqueducts in one go */
+		next = GetOtherTunnelBridgeEnd(tile);
+	} else {
+		next = AddTileIndexDiffCWrap(tile, TileIndexDiffCByDiagDir(dir));
+		if (next == INVALID_TILE) return INVALID_TILE;
+
+		if (type != REGION_WATER) {
+			/* Road stops, depots, tunnels and bridges can only be entered from their front */
+			if (IsTileType(next, MP_TUNNELBRIDGE) && GetTunnelBridgeDirection(next) != dir) return INVALID_TILE;
+			entrance = GetRoadEntrance(next);
+			if (entrance != INVALID_DIAGDIR && entrance != ReverseDiagDir(dir)) return INVALID_TILE;
+		}
+	}
+
+	return (GetRegionTrackdirs(type, next) & DiagdirReachesTrackdirs(dir)) != TRACKDIR_BIT_NONE ? next : INVALID_TILE;
+}
+
+/** Free the regions of all types. */
+static void FreeRegions()
+{
+	for (RegionType type = REGION_WATER; type < REGION_TYPE_END; type++) {
+		if (_regions[type] == NULL) continue;
+
+		for (uint i = 0; i < _regions_x * _regions_y; i++) {
+			if (_regions[type][i] == NULL) continue;
+			free(_regions[type][i]->edges);
+			free(_regions[type][i]);
+		}
+		free(_regions[type]);
+		_regions[type] = NULL;
+		_regions_valid[type] = 0;
+	}
+}
+
+/** Make sure the regions of the given type cover the current map; drop all regions when they don't. */
+static void AllocateRegions(RegionType type)
+{
+	uint size_x = MapSizeX() >> REGION_BITS;
+	uint size_y = MapSizeY() >> REGION_BITS;
+	if (size_x != _regions_x || size_y != _regions_y) {
+		FreeRegions();
+		_regions_x = size_x;
+		_regions_y = size_y;
+	}
+
+	if (_regions[type] == NULL) _regions[type] = CallocT<Region*>(size_x * size_y);
+}
+
+/**
+ * Split the ways of a region into patches and find the connections to
+ * the neighbouring regions. Connections between tiles count in both
+ * directions within the region; most ways can be used both ways and the
+ * pathfinders check the route the regions suggest anyway.
+ * @param type  the kind of ways in the region
+ * @param index the region to update
+ */
+static void UpdateRegion(RegionType type, uint index)
+{
+	Region *r = _regions[type][index];
+	uint x0 = (index % _regions_x) << REGION_BITS;
+	uint y0 = (index / _regions_x) << REGION_BITS;
+
+	TrackdirBits trackdirs[REGION_TILES];
+	for (uint i = 0; i < REGION_TILES; i++) {
+		trackdirs[i] = GetRegionTrackdirs(type, TileXY(x0 + i % REGION_SIZE, y0 + i / REGION_SIZE));
+	}
+
+	memset(r->patch, 0, sizeof(r->patch));
+	r->num_patches = 0;
+	r->num_edges = 0;
+
+	uint stack[REGION_TILES];
+	for (uint first = 0; first < REGION_TILES; first++) {
+		if (trackdirs[first] == TRACKDIR_BIT_NONE || r->patch[first] != 0) continue;
+
+		/* The (very unlikely) patches beyond the 255th are merged into it */
+		if (r->num_patches < 255) r->num_patches++;
+		byte id = r->num_patches;
+
+		uint depth = 0;
+		stack[depth++] = first;
+		r->patch[first] = id;
+		while (depth > 0) {
+			uint i = stack[--depth];
+			TileIndex tile = TileXY(x0 + i % REGION_SIZE, y0 + i / REGION_SIZE);
+
+			for (DiagDirection dir = DIAGDIR_BEGIN; dir < DIAGDIR_END; dir++) {
+				TileIndex next = GetRegionNeighbour(type, tile, trackdirs[i], dir);
+				if (next == INVALID_TILE) continue;
+
+				uint dx = TileX(next) - x0;
+				uint dy = TileY(next) - y0;
+				if (dx < REGION_SIZE && dy < REGION_SIZE) {
+					uint j = dy * REGION_SIZE + dx;
+					if (r->patch[j] == 0) {
+						r->patch[j] = id;
+						stack[depth++] = j;
+					}
+					continue;
+				}
+
+				if (r->num_edges == r->max_edges) {
+					r->max_edges = max(r->max_edges * 2, 16);
+					r->edges = ReallocT(r->edges, r->max_edges);
+				}
+				r->edges[r->num_edges].patch = id;
+				r->edges[r->num_edges].tile = next;
+				r->num_edges++;
+			}
+		}
+	}
+
+	r->valid = true;
+	_regions_valid[type]++;
+}
+
+/** Get a region that matches the map. */
+static Region *GetValidRegion(RegionType type, uint index)
+{
+	Region *&r = _regions[type][index];
+	if (r == NULL) r = CallocT<Region>(1);
+	if (!r->valid) UpdateRegion(type, index);
+	return r;
+}
+
+/**
+ * Get the patch a tile belongs to.
+ * @param type the kind of ways to get the patch of
+ * @param tile the tile to get the patch of
+ * @return the patch, or INVALID_REGION_PATCH when vehicles can't use the tile
+ */
+RegionPatch GetRegionPatch(RegionType type, TileIndex tile)
+{
+	AllocateRegions(type);
+
+	uint index = GetRegionIndex(tile);
+	byte id = GetValidRegion(type, index)->patch[(TileY(tile) % REGION_SIZE) * REGION_SIZE + TileX(tile) % REGION_SIZE];
+	return id == 0 ? INVALID_REGION_PATCH : (type << 26 | index << 8 | id);
+}
+
+/**
+ * Get the patch a tile belongs to when its region matches the map,
+ * without updating any region. Unlike GetRegionPatch() this only reads
+ * the regions, so it can be used by searches on worker threads.
+ * @param type the kind of ways to get the patch of
+ * @param tile the tile to get the patch of
+ * @return the patch, or INVALID_REGION_PATCH when vehicles can't use the tile or its region is not up to date
+ */
+RegionPatch GetKnownRegionPatch(RegionType type, TileIndex tile)
+{
+	if (_regions[type] == NULL || _regions_x != (MapSizeX() >> REGION_BITS) || _regions_y != (MapSizeY() >> REGION_BITS)) return INVALID_REGION_PATCH;
+
+	uint index = GetRegionIndex(tile);
+	const Region *r = _regions[type][index];
+	if (r == NULL || !r->valid) return INVALID_REGION_PATCH;
+
+	byte id = r->patch[(TileY(tile) % REGION_SIZE) * REGION_SIZE + TileX(tile) % REGION_SIZE];
+	return id == 0 ? INVALID_REGION_PATCH : (type << 26 | index << 8 | id);
+}
+
+/**
+ * Get the patches of other regions vehicles can go to directly from a patch.
+ * @param patch      the patch to get the neighbours of
+ * @param neighbours array to store the neighbouring patches in
+ * @param max        the number of entries in neighbours
+ * @return the number of neighbouring patches
+ */
+uint GetRegionPatchNeighbours(RegionPatch patch, RegionPatch *neighbours, uint max)
+{
+	RegionType type = GetRegionPatchType(patch);
+	AllocateRegions(type);
+
+	const Region *r = GetValidRegion(type, GetRegionPatchIndex(patch));
+	byte id = GB(patch, 0, 8);
+	uint count = 0;
+
+	for (uint i = 0; i < r->num_edges && count < max; i++) {
+		if (r->edges[i].patch != id) continue;
+
+		/* Getting the patch can update other regions, but the regions never move */
+		RegionPatch next = GetRegionPatch(type, r->edges[i].tile);
+		if (next == INVALID_REGION_PATCH) continue;
+
+		uint j = 0;
+		while (j < count && neighbours[j] != next) j++;
+		if (j == count) neighbours[count++] = next;
+	}
+
+	return count;
+}
+
+/**
+ * Mark the regions a change of a tile can affect for updating.
+ * @param tile the changed tile, INVALID_TILE when the whole map changed
+ */
+void InvalidateRegions(TileIndex tile)
+{
+	if (tile == INVALID_TILE || tile >= MapSize() || _regions_x != (MapSizeX() >> REGION_BITS) || _regions_y != (MapSizeY() >> REGION_BITS)) {
+		for (RegionType type = REGION_WATER; type < REGION_TYPE_END; type++) {
+			if (_regions[type] == NULL) continue;
+			for (uint i = 0; i < _regions_x * _regions_y; i++) {
+				if (_regions[type][i] != NULL) _regions[type][i]->valid = false;
+			}
+			_regions_valid[type] = 0;
+		}
+		return;
+	}
+
+	/* The connections of the neighbouring tiles to this one may have changed too */
+	static const TileIndexDiffC offsets[] = {{0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+	for (uint i = 0; i < lengthof(offsets); i++) {
+		TileIndex t = AddTileIndexDiffCWrap(tile, offsets[i]);
+		if (t == INVALID_TILE) continue;
+
+		for (RegionType type = REGION_WATER; type < REGION_TYPE_END; type++) {
+			if (_regions[type] == NULL) continue;
+
+			Region *r = _regions[type][GetRegionIndex(t)];
+			if (r == NULL || !r->valid) continue;
+			r->valid = false;
+			_regions_valid[type]--;
+		}
+	}
+}
+
+void YapfGetRegionMemoryUsage(MemoryUsage *usage)
+{
+	usage->name = "yapf_regions";
+	usage->allocated = 0;
+	usage->used = 0;
+	usage->items = 0;
+	usage->capacity = 0;
+	usage->peak = 0;
+
+	for (RegionType type = REGION_WATER; type < REGION_TYPE_END; type++) {
+		if (_regions[type] == NULL) continue;
+
+		uint count = _regions_x * _regions_y;
+		usage->allocated += (uint64)count * sizeof(Region*);
+		usage->used += (uint64)count * sizeof(Region*);
+		for (uint i = 0; i < count; i++) {
+			const Region *r = _regions[type][i];
+			if (r == NULL) continue;
+			usage->allocated += sizeof(Region) + r->max_edges * sizeof(RegionEdge);
+			if (r->valid) usage->used += sizeof(Region) + r->num_edges * sizeof(RegionEdge);
+			usage->capacity++;
+		}
+		usage->items += _regions_valid[type];
+	}
+}
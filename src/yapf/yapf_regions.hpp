@@ -0,0 +1,247 @@
+/* $Id$ */
+
+/** @file yapf_regions.hpp Division of the map into regions of known connectivity, used to plan long routes of ships and road vehicles. */
+
+#ifndef  YAPF_REGIONS_HPP
+#define  YAPF_REGIONS_HPP
+
+/** The kinds of ways the regions are calculated for */
+enum RegionType {
+	REGION_WATER,    ///< the water ships can sail on
+	REGION_ROAD,     ///< the roads road vehicles can drive on
+	REGION_TRAM,     ///< the tram tracks trams can drive on
+	REGION_TYPE_END
+};
+
+/** Allow incrementing of RegionType variables */
+DECLARE_POSTFIX_INCREMENT(RegionType);
+
+enum {
+	REGION_BITS  = 4,                         ///< log2 of the edge length of a region in tiles
+	REGION_SIZE  = 1 << REGION_BITS,          ///< edge length of a region in tiles
+	REGION_TILES = REGION_SIZE * REGION_SIZE, ///< number of tiles in a region
+	MAX_REGION_NEIGHBOURS = 64,               ///< most neighbouring patches GetRegionPatchNeighbours() returns
+};
+
+/**
+ * A patch of a region: the tiles of the region between which vehicles can
+ * move without leaving the region. Bits 0 to 7 are the number of the patch
+ * within the region, bits 8 to 25 the index of the region and bits 26 and up
+ * the RegionType.
+ */
+typedef uint32 RegionPatch;
+
+/** Patch 0 of a region is made of the tiles vehicles can't use. */
+static const RegionPatch INVALID_REGION_PATCH = 0;
+
+/** Get the index of the region the given tile is in. */
+static inline uint GetRegionIndex(TileIndex tile)
+{
+	return (TileY(tile) >> REGION_BITS) * (MapSizeX() >> REGION_BITS) + (TileX(tile) >> REGION_BITS);
+}
+
+/** Get the type of the region of the given patch. */
+static inline RegionType GetRegionPatchType(RegionPatch patch)
+{
+	return (RegionType)GB(patch, 26, 6);
+}
+
+/** Get the index of the region of the given patch. */
+static inline uint GetRegionPatchIndex(RegionPatch patch)
+{
+	return GB(patch, 8, 18);
+}
+
+/** Get the X coordinate of the north tile of the region of the given patch. */
+static inline uint GetRegionPatchX(RegionPatch patch)
+{
+	return (GetRegionPatchIndex(patch) % (MapSizeX() >> REGION_BITS)) << REGION_BITS;
+}
+
+/** Get the Y coordinate of the north tile of the region of the given patch. */
+static inline uint GetRegionPatchY(RegionPatch patch)
+{
+	return (GetRegionPatchIndex(patch) / (MapSizeX() >> REGION_BITS)) << REGION_BITS;
+}
+
+RegionPatch GetRegionPatch(RegionType type, TileIndex tile);
+RegionPatch GetKnownRegionPatch(RegionType type, TileIndex tile);
+uint GetRegionPatchNeighbours(RegionPatch patch, RegionPatch *neighbours, uint max);
+void InvalidateRegions(TileIndex tile);
+
+
+/** Key of the nodes of the region pathfinder: one patch of a region */
+struct CYapfRegionNodeKey {
+	RegionPatch m_patch;
+
+	FORCEINLINE int CalcHash() const {return m_patch;}
+	FORCEINLINE bool operator == (const CYapfRegionNodeKey& other) const {return m_patch == other.m_patch;}
+
+	void Dump(DumpTarget &dmp) const
+	{
+		dmp.WriteLine("m_patch = 0x%X", m_patch);
+	}
+};
+
+/** Node of the region pathfinder */
+struct CYapfRegionNode {
+	typedef CYapfRegionNodeKey Key;
+	typedef CYapfRegionNode Node;
+
+	Key         m_key;
+	Node       *m_hash_next;
+	Node       *m_parent;
+	int         m_cost;
+	int         m_estimate;
+
+	FORCEINLINE void Set(Node *parent, RegionPatch patch)
+	{
+		m_key.m_patch = patch;
+		m_hash_next = NULL;
+		m_parent = parent;
+		m_cost = 0;
+		m_estimate = 0;
+	}
+
+	FORCEINLINE Node* GetHashNext() {return m_hash_next;}
+	FORCEINLINE void SetHashNext(Node *pNext) {m_hash_next = pNext;}
+	FORCEINLINE const Key& GetKey() const {return m_key;}
+	FORCEINLINE int GetCost() {return m_cost;}
+	FORCEINLINE int GetCostEstimate() {return m_estimate;}
+	FORCEINLINE bool operator < (const Node& other) const {return m_estimate < other.m_estimate;}
+
+	void Dump(DumpTarget &dmp) const
+	{
+		dmp.WriteStructT("m_key", &m_key);
+		dmp.WriteStructT("m_parent", m_parent);
+		dmp.WriteLine("m_cost = %d", m_cost);
+		dmp.WriteLine("m_estimate = %d", m_estimate);
+	}
+};
+
+typedef CNodeList_HashTableT<CYapfRegionNode, 10, 12> CRegionNodeList;
+
+/** Distance between two regions, in the cost of crossing a region */
+static inline int RegionDistance(RegionPatch a, RegionPatch b)
+{
+	uint dx = Delta(GetRegionPatchX(a), GetRegionPatchX(b));
+	uint dy = Delta(GetRegionPatchY(a), GetRegionPatchY(b));
+	return (dx + dy) * 10;
+}
+
+/** Origin, destination, follower and cost modules of the region pathfinder.
+ *  It finds the chain of region patches a vehicle passes on its way; crossing
+ *  a region costs as much as going straight through it. */
+template <class Types>
+class CYapfRegionT
+{
+public:
+	typedef typename Types::Tpf Tpf;                     ///< the pathfinder class (derived from THIS class)
+	typedef typename Types::TrackFollower TrackFollower;
+	typedef typename Types::NodeList::Titem Node;        ///< this will be our node type
+
+protected:
+	RegionPatch m_origin;                                ///< the patch the vehicle is in
+	RegionPatch m_dest[DIAGDIR_END + 1];                 ///< the patches the destination can be reached from
+	uint        m_num_dest;                              ///< number of entries in m_dest
+
+	/// to access inherited path finder
+	FORCEINLINE Tpf& Yapf() {return *static_cast<Tpf*>(this);}
+
+public:
+	CYapfRegionT() : m_origin(INVALID_REGION_PATCH), m_num_dest(0) {}
+
+	/** Set the patch the search starts from */
+	void SetOrigin(RegionPatch origin)
+	{
+		m_origin = origin;
+	}
+
+	/** Add a patch the destination can be reached from */
+	void AddDestination(RegionPatch dest)
+	{
+		if (dest == INVALID_REGION_PATCH) return;
+		for (uint i = 0; i < m_num_dest; i++) {
+			if (m_dest[i] == dest) return;
+		}
+		m_dest[m_num_dest++] = dest;
+	}
+
+	/** Called when YAPF needs to place origin nodes into open list */
+	void PfSetStartupNodes()
+	{
+		Node& n = Yapf().CreateNewNode();
+		n.Set(NULL, m_origin);
+		Yapf().AddStartupNode(n);
+	}
+
+	/** Called by YAPF to add all patches reachable from the given one to the open list */
+	inline void PfFollowNode(Node& old_node)
+	{
+		RegionPatch neighbours[MAX_REGION_NEIGHBOURS];
+		uint count = GetRegionPatchNeighbours(old_node.m_key.m_patch, neighbours, lengthof(neighbours));
+
+		TrackFollower F(Yapf().GetVehicle());
+		for (uint i = 0; i < count; i++) {
+			Node& n = Yapf().CreateNewNode();
+			n.Set(&old_node, neighbours[i]);
+			Yapf().AddNewNode(n, F);
+		}
+	}
+
+	/// return debug report character to identify the transportation type
+	FORCEINLINE char TransportTypeChar() const {return 'p';}
+
+	/** Called by YAPF to calculate the cost from the origin to the given node. Tunnels,
+	 *  bridges and aqueducts can lead further than the neighbouring region, so the
+	 *  cost is the distance. */
+	FORCEINLINE bool PfCalcCost(Node& n, const TrackFollower *tf)
+	{
+		n.m_cost = n.m_parent->m_cost + max(RegionDistance(n.m_key.m_patch, n.m_parent->m_key.m_patch), REGION_SIZE * 10);
+		return true;
+	}
+
+	/** Called by YAPF to detect if node ends in the desired destination */
+	FORCEINLINE bool PfDetectDestination(Node& n)
+	{
+		for (uint i = 0; i < m_num_dest; i++) {
+			if (n.m_key.m_patch == m_dest[i]) return true;
+		}
+		return false;
+	}
+
+	/** Called by YAPF to calculate cost estimate; the distance to the nearest destination region */
+	FORCEINLINE bool PfCalcEstimate(Node& n)
+	{
+		int d = INT_MAX;
+		for (uint i = 0; i < m_num_dest; i++) {
+			d = min(d, RegionDistance(n.m_key.m_patch, m_dest[i]));
+		}
+		n.m_estimate = n.m_cost + d;
+		return true;
+	}
+};
+
+/** Config struct of the region pathfinder */
+template <class Tpf_>
+struct CYapfRegion_TypesT
+{
+	typedef CYapfRegion_TypesT<Tpf_>          Types;
+
+	typedef Tpf_                              Tpf;
+	typedef CFollowTrackWater                 TrackFollower; ///< only passed along to AddNewNode(), which needs one
+	typedef CRegionNodeList                   NodeList;
+	typedef CYapfBaseT<Types>                 PfBase;
+	typedef CYapfRegionT<Types>               PfFollow;
+	typedef CYapfSegmentCostCacheNoneT<Types> PfCache;
+};
+
+/** The region pathfinder; all modules but the base and the cache are in CYapfRegionT */
+struct CYapfRegion
+	: public CYapfRegion_TypesT<CYapfRegion>::PfBase
+	, public CYapfRegion_TypesT<CYapfRegion>::PfFollow
+	, public CYapfRegion_TypesT<CYapfRegion>::PfCache
+{
+};
+
+#endif /* YAPF_REGIONS_HPP */
@@ -6,6 +6,7 @@
 
 #include "yapf.hpp"
 #include "yapf_node_road.hpp"
+#include "yapf_regions.hpp"
 
 
 template <class Types>
@@ -74,17 +75,43 @@ public:
 	 *  and stores the result into Node::m_cost member */
 	FORCEINLINE bool PfCalcCost(Node& n, const TrackFollower *tf)
 	{
+		const Vehicle* v = Yapf().GetVehicle();
+		CYapfRoadSegment &segment = *n.m_segment;
+		int parent_cost = (n.m_parent != NULL) ? n.m_parent->m_cost : 0;
+
+		/* The cached cost leaves out the speed limit penalties and does not know
+		 * about the destination of the vehicle, which may end the segment early. */
+		if (segment.IsCostCached() && v->max_speed <= segment.m_max_speed &&
+				(v->current_order.type != OT_GOTO_STATION || !segment.ContainsTile(v->dest_tile))) {
+			CSegmentCostCacheT<CYapfRoadSegment>::s_stats.hits++;
+			if (segment.m_loop) return false;
+			n.m_segment_last_tile = segment.m_last_tile;
+			n.m_segment_last_td = segment.m_last_td;
+			n.m_cost = parent_cost + segment.m_cost;
+			return true;
+		}
+		CSegmentCostCacheT<CYapfRoadSegment>::s_stats.misses++;
+
+		/* A cached segment this vehicle can't use must stay as it is */
+		bool store = !segment.IsCostCached();
 		int segment_cost = 0;
+		int speed_penalty = 0;
+		int max_segment_speed = INT_MAX;
+		bool loop = false;
 		// start at n.m_key.m_tile / n.m_key.m_td and walk to the end of segment
 		TileIndex tile = n.m_key.m_tile;
 		Trackdir trackdir = n.m_key.m_td;
 		while (true) {
+			if (store) segment.AddTile(tile);
+
 			// base tile cost depending on distance between edges
 			segment_cost += Yapf().OneTileCost(tile, trackdir);
 
-			const Vehicle* v = Yapf().GetVehicle();
 			// we have reached the vehicle's destination - segment should end here to avoid target skipping
-			if (v->current_order.type == OT_GOTO_STATION && tile == v->dest_tile) break;
+			if (v->current_order.type == OT_GOTO_STATION && tile == v->dest_tile) {
+				store = false;
+				break;
+			}
 
 			// stop if we have just entered the depot
 			if (IsTileDepotType(tile, TRANSPORT_ROAD) && trackdir == DiagdirToDiagTrackdir(ReverseDiagDir(GetRoadDepotDirection(tile)))) {
@@ -95,6 +122,7 @@ public:
 			// if there are no reachable trackdirs on new tile, we have end of road
 			TrackFollower F(Yapf().GetVehicle());
 			if (!F.Follow(tile, trackdir)) break;
+			if (store) segment.AddTile(F.m_new_tile);
 
 			// if there are more trackdirs available & reachable, we are at the end of segment
 			if (KillFirstBit(F.m_new_td_bits) != TRACKDIR_BIT_NONE) break;
@@ -102,7 +130,10 @@ public:
 			Trackdir new_td = (Trackdir)FindFirstBit2x64(F.m_new_td_bits);
 
 			// stop if RV is on simple loop with no junctions
-			if (F.m_new_tile == n.m_key.m_tile && new_td == n.m_key.m_td) return false;
+			if (F.m_new_tile == n.m_key.m_tile && new_td == n.m_key.m_td) {
+				loop = true;
+				break;
+			}
 
 			// if we skipped some tunnel tiles, add their cost
 			segment_cost += F.m_tiles_skipped * YAPF_TILE_LENGTH;
@@ -113,26 +144,88 @@ public:
 			// add min/max speed penalties
 			int min_speed = 0;
 			int max_speed = F.GetSpeedLimit(&min_speed);
-			if (max_speed < v->max_speed) segment_cost += 1 * (v->max_speed - max_speed);
-			if (min_speed > v->max_speed) segment_cost += 10 * (min_speed - v->max_speed);
+			if (max_speed < v->max_speed) speed_penalty += 1 * (v->max_speed - max_speed);
+			if (min_speed > v->max_speed) speed_penalty += 10 * (min_speed - v->max_speed);
+			max_segment_speed = min(max_segment_speed, max_speed);
+			if (min_speed > 0) store = false;
 
 			// move to the next tile
 			tile = F.m_new_tile;
 			trackdir = new_td;
 		};
 
+		if (store) {
+			segment.m_last_tile = tile;
+			segment.m_last_td = trackdir;
+			segment.m_cost = segment_cost;
+			segment.m_max_speed = max_segment_speed;
+			segment.m_loop = loop;
+		} else if (!segment.IsCostCached()) {
+			segment.ResetArea();
+		}
+
+		if (loop) return false;
+
 		// save end of segment back to the node
 		n.m_segment_last_tile = tile;
 		n.m_segment_last_td = trackdir;
 
 		// save also tile cost
-		int parent_cost = (n.m_parent != NULL) ? n.m_parent->m_cost : 0;
-		n.m_cost = parent_cost + segment_cost;
+		n.m_cost = parent_cost + segment_cost + speed_penalty;
 		return true;
 	}
 };
 
 
+/** Cost cache provider of road YAPF. The segments of all road YAPF types are
+ *  kept in one cache, as their costs don't depend on the destination. */
+template <class Types>
+class CYapfSegmentCostCacheRoadT
+{
+public:
+	typedef typename Types::Tpf Tpf;              ///< the pathfinder class (derived from THIS class)
+	typedef typename Types::NodeList::Titem Node; ///< this will be our node type
+	typedef CSegmentCostCacheT<CYapfRoadSegment> Cache;
+
+protected:
+	Cache&      m_global_cache;
+
+	FORCEINLINE CYapfSegmentCostCacheRoadT() : m_global_cache(GetRoadSegmentCache()) {};
+
+	/// to access inherited path finder
+	FORCEINLINE Tpf& Yapf() {return *static_cast<Tpf*>(this);}
+
+	static Cache& GetRoadSegmentCache()
+	{
+		static Cache C;
+
+		// drop the segments the road layout changes went through
+		C.ProcessChanges();
+		return C;
+	}
+
+public:
+	/** Called by YAPF to attach the cached segment to the given node. The origin
+	 *  nodes have no segment cost, so they don't get a segment.
+	 *  @return true if the segment has a cached cost, which the vehicle may still be unable to use */
+	FORCEINLINE bool PfNodeCacheFetch(Node& n)
+	{
+		if (n.m_parent == NULL) return false;
+		CYapfRoadSegmentKey key(n.GetTile(), n.GetTrackdir(), Yapf().GetVehicle());
+		bool found;
+		n.m_segment = &m_global_cache.Get(key, &found);
+		return found;
+	};
+
+	/** Called by YAPF after the cost of the node was calculated; registers newly
+	 *  calculated segments so road layout changes can find them. */
+	FORCEINLINE void PfNodeCacheFlush(Node& n)
+	{
+		m_global_cache.Register(*n.m_segment);
+	};
+};
+
+
 template <class Types>
 class CYapfDestinationAnyDepotRoadT
 {
@@ -162,6 +255,14 @@ public:
 };
 
 
+/** Compare two region patches, for sorting them with qsort(). */
+static int CDECL CompareRegionPatches(const void *a, const void *b)
+{
+	RegionPatch pa = *(const RegionPatch*)a;
+	RegionPatch pb = *(const RegionPatch*)b;
+	return (pa > pb) - (pa < pb);
+}
+
 template <class Types>
 class CYapfDestinationTileRoadT
 {
@@ -171,9 +272,14 @@ public:
 	typedef typename Types::NodeList::Titem Node;        ///< this will be our node type
 	typedef typename Node::Key Key;                      ///< key to hash tables
 
+	enum {
+		MIN_CORRIDOR_REGIONS = 5, ///< number of region patches a route must pass before the search is limited to them
+	};
+
 protected:
 	TileIndex    m_destTile;
 	TrackdirBits m_destTrackdirs;
+	SmallVector<RegionPatch, 32> m_corridor; ///< sorted patches of the regions on the way, empty to search all roads
 
 public:
 	void SetDestination(TileIndex tile, TrackdirBits trackdirs)
@@ -182,6 +288,40 @@ public:
 		m_destTrackdirs = trackdirs;
 	}
 
+	/**
+	 * Find the regions on the way to the destination and limit the search
+	 * to the roads that start in them.
+	 * @param v    the road vehicle
+	 * @param tile the tile the vehicle is entering
+	 * @return true if the destination is far enough away to limit the search
+	 */
+	bool SetRegionCorridor(const Vehicle *v, TileIndex tile)
+	{
+		/* Destinations this close seldom lie MIN_CORRIDOR_REGIONS patches away; skip the region search */
+		if (DistanceManhattan(tile, m_destTile) < MIN_CORRIDOR_REGIONS * REGION_SIZE) return false;
+
+		RegionType type = HasBit(v->u.road.compatible_roadtypes, ROADTYPE_TRAM) ? REGION_TRAM : REGION_ROAD;
+		RegionPatch origin = GetRegionPatch(type, tile);
+		RegionPatch dest = GetRegionPatch(type, m_destTile);
+		if (origin == INVALID_REGION_PATCH || dest == INVALID_REGION_PATCH) return false;
+
+		CYapfRegion pf;
+		pf.SetOrigin(origin);
+		pf.AddDestination(dest);
+		if (!pf.FindPath(v)) return false;
+
+		for (const CYapfRegionNode *n = pf.GetBestNode(); n != NULL; n = n->m_parent) {
+			*m_corridor.Append() = n->m_key.m_patch;
+		}
+		if (m_corridor.Length() < MIN_CORRIDOR_REGIONS) {
+			m_corridor.Clear();
+			return false;
+		}
+
+		qsort(m_corridor.Begin(), m_corridor.Length(), sizeof(RegionPatch), CompareRegionPatches);
+		return true;
+	}
+
 protected:
 	/// to access inherited path finder
 	Tpf& Yapf() {return *static_cast<Tpf*>(this);}
@@ -194,8 +334,29 @@ public:
 		return bDest;
 	}
 
+	/** Check whether the road of a node starts in one of the regions on the way to the destination. */
+	inline bool IsInCorridor(Node& n)
+	{
+		RegionPatch patch = GetRegionPatch(GetRegionPatchType(*m_corridor.Begin()), n.GetTile());
+		/* Bits of tram track that end a line are left out of the regions */
+		if (patch == INVALID_REGION_PATCH) return true;
+
+		uint first = 0;
+		uint last = m_corridor.Length();
+		while (first < last) {
+			uint middle = (first + last) / 2;
+			if (m_corridor.Begin()[middle] < patch) {
+				first = middle + 1;
+			} else {
+				last = middle;
+			}
+		}
+		return first < m_corridor.Length() && m_corridor.Begin()[first] == patch;
+	}
+
 	/** Called by YAPF to calculate cost estimate. Calculates distance to the destination
-	 *  adds it to the actual cost from origin and stores the sum to the Node::m_estimate */
+	 *  adds it to the actual cost from origin and stores the sum to the Node::m_estimate.
+	 *  When the search is limited to the regions on the way, other nodes are dropped. */
 	inline bool PfCalcEstimate(Node& n)
 	{
 		static int dg_dir_to_x_offs[] = {-1, 0, 1, 0};
@@ -204,6 +365,7 @@ public:
 			n.m_estimate = n.m_cost;
 			return true;
 		}
+		if (m_corridor.Length() != 0 && n.m_parent != NULL && !IsInCorridor(n)) return false;
 
 		TileIndex tile = n.m_segment_last_tile;
 		DiagDirection exitdir = TrackdirToExitdir(n.m_segment_last_td);
@@ -254,16 +416,35 @@ public:
 
 	static Trackdir stChooseRoadTrack(Vehicle *v, TileIndex tile, DiagDirection enterdir)
 	{
+		/* Far away destinations are searched for along the regions on the way;
+		 * all roads are only searched when that doesn't find a path. */
+		Trackdir next_trackdir;
+		{
+			Tpf pf;
+			if (pf.ChooseRoadTrack(v, tile, enterdir, true, &next_trackdir)) return next_trackdir;
+		}
 		Tpf pf;
-		return pf.ChooseRoadTrack(v, tile, enterdir);
+		pf.ChooseRoadTrack(v, tile, enterdir, false, &next_trackdir);
+		return next_trackdir;
 	}
 
-	FORCEINLINE Trackdir ChooseRoadTrack(Vehicle *v, TileIndex tile, DiagDirection enterdir)
+	/**
+	 * Search the way to the destination of a road vehicle.
+	 * @param v             the road vehicle
+	 * @param tile          the tile the vehicle is entering
+	 * @param enterdir      the direction the vehicle enters the tile in
+	 * @param use_regions   whether to limit the search to the regions on the way
+	 * @param next_trackdir the trackdir to take on tile, INVALID_TRACKDIR if none
+	 * @return false if the search was limited to the regions on the way and failed,
+	 *         or the destination is close enough to do without
+	 */
+	inline bool ChooseRoadTrack(Vehicle *v, TileIndex tile, DiagDirection enterdir, bool use_regions, Trackdir *next_trackdir)
 	{
 		// handle special case - when next tile is destination tile
 		if (tile == v->dest_tile) {
 			// choose diagonal trackdir reachable from enterdir
-			return (Trackdir)DiagdirToDiagTrackdir(enterdir);
+			*next_trackdir = (Trackdir)DiagdirToDiagTrackdir(enterdir);
+			return true;
 		}
 		// our source tile will be the next vehicle tile (should be the given one)
 		TileIndex src_tile = tile;
@@ -279,12 +460,13 @@ public:
 		// set origin and destination nodes
 		Yapf().SetOrigin(src_tile, src_trackdirs);
 		Yapf().SetDestination(dest_tile, dest_trackdirs);
+		if (use_regions && !Yapf().SetRegionCorridor(v, tile)) return false;
 
 		// find the best path
-		Yapf().FindPath(v);
+		if (!Yapf().FindPath(v) && use_regions) return false;
 
 		// if path not found - return INVALID_TRACKDIR
-		Trackdir next_trackdir = INVALID_TRACKDIR;
+		*next_trackdir = INVALID_TRACKDIR;
 		Node *pNode = Yapf().GetBestNode();
 		if (pNode != NULL) {
 			// path was found or at least suggested
@@ -295,9 +477,9 @@ public:
 			// return trackdir from the best origin node (one of start nodes)
 			Node& best_next_node = *pNode;
 			assert(best_next_node.GetTile() == tile);
-			next_trackdir = best_next_node.GetTrackdir();
+			*next_trackdir = best_next_node.GetTrackdir();
 		}
-		return next_trackdir;
+		return true;
 	}
 
 	static uint stDistanceToTile(const Vehicle *v, TileIndex tile)
@@ -390,7 +572,7 @@ struct CYapfRoad_TypesT
 	typedef CYapfFollowRoadT<Types>           PfFollow;
 	typedef CYapfOriginTileT<Types>           PfOrigin;
 	typedef Tdestination<Types>               PfDestination;
-	typedef CYapfSegmentCostCacheNoneT<Types> PfCache;
+	typedef CYapfSegmentCostCacheRoadT<Types> PfCache;
 	typedef CYapfCostRoadT<Types>             PfCost;
 };
 
@@ -459,3 +641,8 @@ bool YapfFindNearestRoadDepot(const Vehicle *v, int max_distance, TileIndex *dep
 	bool ret = pfnFindNearestDepot(v, tile, trackdir, max_distance, depot_tile);
 	return ret;
 }
+
+void YapfGetRoadCacheStats(YapfCacheStats *stats)
+{
+	*stats = CSegmentCostCacheT<CYapfRoadSegment>::s_stats;
+}
@@ -5,6 +5,107 @@
 #include "../stdafx.h"
 
 #include "yapf.hpp"
+#include "yapf_regions.hpp"
+
+enum {
+	SHIP_CORRIDOR_REGIONS = 5, ///< number of water region patches, including the one of the ship, a search may visit
+};
+
+/**
+ * Find the water regions on the way to the destination of a ship.
+ * @param v        the ship
+ * @param tile     the tile the ship is entering
+ * @param corridor array of SHIP_CORRIDOR_REGIONS patches to store the patches from the ship on in
+ * @return the number of patches stored; 0 if the destination is not further away than the corridor
+ */
+static uint FindShipCorridor(const Vehicle *v, TileIndex tile, RegionPatch *corridor)
+{
+	RegionPatch origin = GetRegionPatch(REGION_WATER, tile);
+	if (origin == INVALID_REGION_PATCH) return 0;
+
+	CYapfRegion pf;
+	pf.SetOrigin(origin);
+	/* Docks and the like are often next to the water the ship has to get to */
+	pf.AddDestination(GetRegionPatch(REGION_WATER, v->dest_tile));
+	for (DiagDirection dir = DIAGDIR_BEGIN; dir < DIAGDIR_END; dir++) {
+		TileIndex t = AddTileIndexDiffCWrap(v->dest_tile, TileIndexDiffCByDiagDir(dir));
+		if (t != INVALID_TILE) pf.AddDestination(GetRegionPatch(REGION_WATER, t));
+	}
+	if (!pf.FindPath(v)) return 0;
+
+	uint length = 0;
+	const CYapfRegionNode *n = pf.GetBestNode();
+	for (const CYapfRegionNode *p = n; p != NULL; p = p->m_parent) length++;
+	if (length <= SHIP_CORRIDOR_REGIONS) return 0;
+
+	/* Skip the far end of the route, then store the patches from the ship on */
+	for (; length > SHIP_CORRIDOR_REGIONS; length--) n = n->m_parent;
+	for (; n != NULL; n = n->m_parent) corridor[--length] = n->m_key.m_patch;
+	return SHIP_CORRIDOR_REGIONS;
+}
+
+/** Destination module of YAPF for ships. For far away destinations it limits
+ *  the search to the water region patches the ship is going to pass first,
+ *  and looks for the way into the last of them. */
+template <class Types>
+class CYapfDestinationShipT
+	: public CYapfDestinationTileT<Types>
+{
+public:
+	typedef CYapfDestinationTileT<Types> base;
+	typedef typename Types::NodeList::Titem Node;        ///< this will be our node type
+
+protected:
+	RegionPatch m_corridor[SHIP_CORRIDOR_REGIONS];       ///< patches the search may visit; the last one is the destination
+	uint        m_corridor_length;                       ///< number of patches in m_corridor, 0 to search all water
+
+public:
+	CYapfDestinationShipT() : m_corridor_length(0) {}
+
+	/**
+	 * Limit the search to the patches found by FindShipCorridor().
+	 * @param corridor the patches from the ship on
+	 * @param length   the number of patches
+	 */
+	void SetRegionCorridor(const RegionPatch *corridor, uint length)
+	{
+		for (uint i = 0; i < length; i++) m_corridor[i] = corridor[i];
+		m_corridor_length = length;
+	}
+
+	/// Called by YAPF to detect if node ends in the desired destination
+	FORCEINLINE bool PfDetectDestination(Node& n)
+	{
+		if (m_corridor_length == 0) return base::PfDetectDestination(n);
+		/* The patches of the corridor are up to date, so regions that are not can be skipped */
+		return GetKnownRegionPatch(REGION_WATER, n.GetTile()) == m_corridor[m_corridor_length - 1];
+	}
+
+	/** Called by YAPF to calculate cost estimate. Nodes outside the corridor
+	 *  are dropped; the others get the distance to the last region of it. */
+	inline bool PfCalcEstimate(Node& n)
+	{
+		if (m_corridor_length == 0) return base::PfCalcEstimate(n);
+
+		RegionPatch patch = GetKnownRegionPatch(REGION_WATER, n.GetTile());
+		uint i = 0;
+		while (i < m_corridor_length && m_corridor[i] != patch) i++;
+		if (i == m_corridor_length) return false;
+
+		/* Each tile on the way to the nearest tile of the region costs at least 7 */
+		RegionPatch dest = m_corridor[m_corridor_length - 1];
+		int x = TileX(n.GetTile());
+		int y = TileY(n.GetTile());
+		int x1 = GetRegionPatchX(dest);
+		int y1 = GetRegionPatchY(dest);
+		int dx = (x < x1) ? x1 - x : max(0, x - (x1 + REGION_SIZE - 1));
+		int dy = (y < y1) ? y1 - y : max(0, y - (y1 + REGION_SIZE - 1));
+		int dmin = min(dx, dy);
+		int dxy = abs(dx - dy);
+		n.m_estimate = n.m_cost + dmin * 7 + dxy * (10 / 2);
+		return true;
+	}
+};
 
 /** Node Follower module of YAPF for ships */
 template <class Types>
@@ -34,20 +135,21 @@ public:
 	/// return debug report character to identify the transportation type
 	FORCEINLINE char TransportTypeChar() const {return 'w';}
 
-	static Trackdir ChooseShipTrack(Vehicle *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks)
+	/**
+	 * Search the way to the destination of a ship. Only reads the map and
+	 * the regions of the corridor, so it can run on a worker thread.
+	 * @param v               the ship
+	 * @param tile            the tile the ship is entering
+	 * @param enterdir        the direction the ship enters the tile in
+	 * @param trackdir        the trackdir of the ship on the tile it leaves
+	 * @param corridor        the water regions on the way, see FindShipCorridor()
+	 * @param corridor_length the number of patches in corridor
+	 * @return the trackdir to take on tile, INVALID_TRACKDIR if none
+	 */
+	static Trackdir ChooseShipTrack(const Vehicle *v, TileIndex tile, DiagDirection enterdir, Trackdir trackdir, const RegionPatch *corridor, uint corridor_length)
 	{
-		// handle special case - when next tile is destination tile
-		if (tile == v->dest_tile) {
-			// convert tracks to trackdirs
-			TrackdirBits trackdirs = (TrackdirBits)(tracks | ((int)tracks << 8));
-			// choose any trackdir reachable from enterdir
-			trackdirs &= DiagdirReachesTrackdirs(enterdir);
-			return (Trackdir)FindFirstBit2x64(trackdirs);
-		}
-
 		// move back to the old tile/trackdir (where ship is coming from)
 		TileIndex src_tile = TILE_ADD(tile, TileOffsByDiagDir(ReverseDiagDir(enterdir)));
-		Trackdir trackdir = GetVehicleTrackdir(v);
 		assert(IsValidTrackdir(trackdir));
 
 		// convert origin trackdir to TrackdirBits
@@ -55,15 +157,38 @@ public:
 		// get available trackdirs on the destination tile
 		TrackdirBits dest_trackdirs = TrackStatusToTrackdirBits(GetTileTrackStatus(v->dest_tile, TRANSPORT_WATER, 0));
 
+		/* Far away destinations are approached through the water regions on the
+		 * way; the whole water is only searched when that doesn't find a path. */
+		Trackdir next_trackdir;
+		if (corridor_length != 0 && FindShipPath(v, tile, src_tile, trackdirs, dest_trackdirs, corridor, corridor_length, &next_trackdir)) return next_trackdir;
+		FindShipPath(v, tile, src_tile, trackdirs, dest_trackdirs, NULL, 0, &next_trackdir);
+		return next_trackdir;
+	}
+
+	/**
+	 * Search the way to the destination of a ship.
+	 * @param v               the ship
+	 * @param tile            the tile the ship is entering
+	 * @param src_tile        the tile the ship is leaving
+	 * @param trackdirs       the trackdir of the ship on src_tile
+	 * @param dest_trackdirs  the trackdirs on the destination tile
+	 * @param corridor        the water regions the search is limited to, NULL to search all water
+	 * @param corridor_length the number of patches in corridor
+	 * @param next_trackdir   the trackdir to take on tile, INVALID_TRACKDIR if none
+	 * @return false if the search was limited to the corridor and failed
+	 */
+	static bool FindShipPath(const Vehicle *v, TileIndex tile, TileIndex src_tile, TrackdirBits trackdirs, TrackdirBits dest_trackdirs, const RegionPatch *corridor, uint corridor_length, Trackdir *next_trackdir)
+	{
 		// create pathfinder instance
 		Tpf pf;
 		// set origin and destination nodes
 		pf.SetOrigin(src_tile, trackdirs);
 		pf.SetDestination(v->dest_tile, dest_trackdirs);
+		pf.SetRegionCorridor(corridor, corridor_length);
 		// find best path
-		pf.FindPath(v);
+		if (!pf.FindPath(v) && corridor_length != 0) return false;
 
-		Trackdir next_trackdir = INVALID_TRACKDIR; // this would mean "path not found"
+		*next_trackdir = INVALID_TRACKDIR; // this would mean "path not found"
 
 		Node* pNode = pf.GetBestNode();
 		if (pNode != NULL) {
@@ -76,9 +201,9 @@ public:
 			// return trackdir from the best next node (direct child of origin)
 			Node& best_next_node = *pPrevNode;
 			assert(best_next_node.GetTile() == tile);
-			next_trackdir = best_next_node.GetTrackdir();
+			*next_trackdir = best_next_node.GetTrackdir();
 		}
-		return next_trackdir;
+		return true;
 	}
 };
 
@@ -134,7 +259,7 @@ struct CYapfShip_TypesT
 	typedef CYapfBaseT<Types>                 PfBase;        // base pathfinder class
 	typedef CYapfFollowShipT<Types>           PfFollow;      // node follower
 	typedef CYapfOriginTileT<Types>           PfOrigin;      // origin provider
-	typedef CYapfDestinationTileT<Types>      PfDestination; // destination/distance provider
+	typedef CYapfDestinationShipT<Types>      PfDestination; // destination/distance provider
 	typedef CYapfSegmentCostCacheNoneT<Types> PfCache;       // segment cost cache provider
 	typedef CYapfCostShipT<Types>             PfCost;        // cost provider
 };
@@ -146,20 +271,148 @@ struct CYapfShip2 : CYapfT<CYapfShip_TypesT<CYapfShip2, CFollowTrackWater    , C
 // YAPF type 3 - uses TileIndex/Trackdir as Node key, forbids 90-deg turns
 struct CYapfShip3 : CYapfT<CYapfShip_TypesT<CYapfShip3, CFollowTrackWaterNo90, CShipNodeListTrackDir> > {};
 
+typedef Trackdir (*PfnChooseShipTrack)(const Vehicle*, TileIndex, DiagDirection, Trackdir, const RegionPatch*, uint);
+
+/** Get the ship pathfinder the patch settings ask for. */
+static PfnChooseShipTrack GetShipPathfinder()
+{
+	// check if non-default YAPF type needed
+	if (_patches.forbid_90_deg) return &CYapfShip3::ChooseShipTrack; // Trackdir, forbid 90-deg
+	if (_patches.yapf.disable_node_optimization) return &CYapfShip1::ChooseShipTrack; // Trackdir, allow 90-deg
+	return &CYapfShip2::ChooseShipTrack; // default: ExitDir, allow 90-deg
+}
+
+/** A ship path search made before the tick of the ship, see YapfRunShipSearches(). */
+struct ShipSearch {
+	VehicleID veh;            ///< the ship
+	TileIndex tile;           ///< the tile the ship is expected to enter
+	DiagDirection enterdir;   ///< the direction the ship enters the tile in
+	TileIndex dest_tile;      ///< the destination of the ship
+	Trackdir trackdir;        ///< the trackdir of the ship on the tile it leaves
+	RegionPatch corridor[SHIP_CORRIDOR_REGIONS]; ///< the water regions on the way
+	uint corridor_length;     ///< the number of patches in corridor
+	Trackdir result;          ///< the trackdir to take on tile
+};
+
+/** The ship searches of this tick, in vehicle index order. */
+static SmallVector<ShipSearch, 16> _ship_searches;
+/** The first search of _ship_searches that is not yet taken by its ship. */
+static uint _ship_search_pos = 0;
+
+/** The searches one thread makes. */
+struct ShipSearchJob {
+	ShipSearch *first; ///< the first search
+	ShipSearch *last;  ///< one past the last search
+};
+
+static void *RunShipSearchJob(void *arg)
+{
+	const ShipSearchJob *job = (const ShipSearchJob*)arg;
+	PfnChooseShipTrack pfnChooseShipTrack = GetShipPathfinder();
+
+	for (ShipSearch *s = job->first; s != job->last; s++) {
+		s->result = pfnChooseShipTrack(GetVehicle(s->veh), s->tile, s->enterdir, s->trackdir, s->corridor, s->corridor_length);
+	}
+
+	return NULL;
+}
+
+/**
+ * Queue the search of a ship that is expected to enter a tile during its
+ * next tick. The water regions on the way are found right away, as they
+ * are updated when they are used; the rest of the search only reads the
+ * map and is left to YapfRunShipSearches(). Ships must be queued in
+ * vehicle index order.
+ * @param v        the ship
+ * @param tile     the tile the ship is expected to enter
+ * @param enterdir the direction the ship enters the tile in
+ */
+void YapfQueueShipSearch(const Vehicle *v, TileIndex tile, DiagDirection enterdir)
+{
+	/* Entering the destination needs no search */
+	if (tile == v->dest_tile) return;
+
+	ShipSearch *s = _ship_searches.Append();
+	s->veh = v->index;
+	s->tile = tile;
+	s->enterdir = enterdir;
+	s->dest_tile = v->dest_tile;
+	s->trackdir = GetVehicleTrackdir(v);
+	s->corridor_length = FindShipCorridor(v, tile, s->corridor);
+	s->result = INVALID_TRACKDIR;
+}
+
+/**
+ * Run the queued ship searches, spread over the worker threads of the
+ * parallel tile loop. Each search only depends on its own inputs, so the
+ * answers do not depend on the number of threads or on their timing.
+ */
+void YapfRunShipSearches()
+{
+	uint count = _ship_searches.Length();
+	if (count == 0) return;
+
+	ShipSearchJob jobs[64];
+	void *args[lengthof(jobs)];
+	uint num_jobs = minu(minu(GetWorkerJobCount(), lengthof(jobs)), count);
+	for (uint i = 0; i < num_jobs; i++) {
+		jobs[i].first = _ship_searches.Begin() + count * i / num_jobs;
+		jobs[i].last  = _ship_searches.Begin() + count * (i + 1) / num_jobs;
+		args[i] = &jobs[i];
+	}
+
+	CNodeListSpareBase::s_threaded = true;
+	RunWorkerJobs(&RunShipSearchJob, args, num_jobs);
+	CNodeListSpareBase::s_threaded = false;
+}
+
+/** Drop the ship searches of this tick; the map they were made for changed, or the tick is over. */
+void YapfClearShipSearches()
+{
+	_ship_searches.Clear();
+	_ship_search_pos = 0;
+}
+
+/**
+ * Take the answer of a queued search when the ship asks what it was made for.
+ * @param v        the ship
+ * @param tile     the tile the ship is entering
+ * @param enterdir the direction the ship enters the tile in
+ * @param trackdir the trackdir to take on tile
+ * @return whether a queued search matched
+ */
+static bool TakeShipSearch(const Vehicle *v, TileIndex tile, DiagDirection enterdir, Trackdir *trackdir)
+{
+	/* Ships tick in index order; the searches of ships before this one are not taken anymore */
+	while (_ship_search_pos < _ship_searches.Length() && _ship_searches[_ship_search_pos].veh < v->index) _ship_search_pos++;
+	if (_ship_search_pos == _ship_searches.Length()) return false;
+
+	const ShipSearch *s = &_ship_searches[_ship_search_pos];
+	if (s->veh != v->index || s->tile != tile || s->enterdir != enterdir || s->dest_tile != v->dest_tile || s->trackdir != GetVehicleTrackdir(v)) return false;
+
+	_ship_search_pos++;
+	*trackdir = s->result;
+	return true;
+}
+
 /** Ship controller helper - path finder invoker */
 Trackdir YapfChooseShipTrack(Vehicle *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks)
 {
-	// default is YAPF type 2
-	typedef Trackdir (*PfnChooseShipTrack)(Vehicle*, TileIndex, DiagDirection, TrackBits);
-	PfnChooseShipTrack pfnChooseShipTrack = CYapfShip2::ChooseShipTrack; // default: ExitDir, allow 90-deg
+	// handle special case - when next tile is destination tile
+	if (tile == v->dest_tile) {
+		// convert tracks to trackdirs
+		TrackdirBits trackdirs = (TrackdirBits)(tracks | ((int)tracks << 8));
+		// choose any trackdir reachable from enterdir
+		trackdirs &= DiagdirReachesTrackdirs(enterdir);
+		return (Trackdir)FindFirstBit2x64(trackdirs);
+	}
 
-	// check if non-default YAPF type needed
-	if (_patches.forbid_90_deg)
-		pfnChooseShipTrack = &CYapfShip3::ChooseShipTrack; // Trackdir, forbid 90-deg
-	else if (_patches.yapf.disable_node_optimization)
-		pfnChooseShipTrack = &CYapfShip1::ChooseShipTrack; // Trackdir, allow 90-deg
+	Trackdir td_ret;
+	if (TakeShipSearch(v, tile, enterdir, &td_ret)) return td_ret;
 
-	Trackdir td_ret = pfnChooseShipTrack(v, tile, enterdir, tracks);
+	RegionPatch corridor[SHIP_CORRIDOR_REGIONS];
+	uint corridor_length = FindShipCorridor(v, tile, corridor);
+	td_ret = GetShipPathfinder()(v, tile, enterdir, GetVehicleTrackdir(v), corridor, corridor_length);
 	return td_ret;
 }
 